@@ -0,0 +1,287 @@
+#include "FGitCatFileBatch.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	FCriticalSection WorkersCS;
+	TMap<FString, TSharedPtr<FGitCatFileBatch, ESPMode::ThreadSafe>> Workers;
+	// requests written before reading the responses, git blocks when the pipe of output is full
+	const int32 MaxPipelinedRequests = 64;
+}
+
+FGitCatFileBatch::FGitCatFileBatch(const FString& InPathToGitBinary, const FString& InRepositoryRoot, EMode InMode)
+	: GitBinary(InPathToGitBinary)
+	, RepositoryRoot(InRepositoryRoot)
+	, Mode(InMode)
+{
+}
+
+FGitCatFileBatch::~FGitCatFileBatch()
+{
+	Stop();
+}
+
+bool FGitCatFileBatch::Start()
+{
+	Stop();
+	FString FullCommand;
+	if (!RepositoryRoot.IsEmpty())
+	{
+		FullCommand = TEXT("-C \"");
+		FullCommand += RepositoryRoot;
+		FullCommand += TEXT("\" ");
+	}
+	switch (Mode)
+	{
+	case EMode::Check: FullCommand += TEXT("cat-file --batch-check"); break;
+	case EMode::Content: FullCommand += TEXT("cat-file --batch"); break;
+	case EMode::FilteredContent: FullCommand += TEXT("cat-file --batch --filters"); break;
+	}
+
+	verify(FPlatformProcess::CreatePipe(StdOutRead, StdOutWrite));
+	verify(FPlatformProcess::CreatePipe(StdInRead, StdInWrite, true));
+	ProcessHandle = FPlatformProcess::CreateProc(*GitBinary, *FullCommand, false, true, true, nullptr, 0, RepositoryRoot.IsEmpty() ? nullptr : *RepositoryRoot, StdOutWrite, StdInRead);
+	if (!ProcessHandle.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to launch 'git %s'"), *FullCommand);
+		Stop();
+		return false;
+	}
+	return true;
+}
+
+void FGitCatFileBatch::Stop()
+{
+	if (ProcessHandle.IsValid())
+	{
+		// git exits at the end of stdin
+		FPlatformProcess::ClosePipe(StdInRead, StdInWrite);
+		StdInRead = StdInWrite = nullptr;
+		for (int32 Index = 0; Index < 100 && FPlatformProcess::IsProcRunning(ProcessHandle); ++Index)
+		{
+			FPlatformProcess::Sleep(0.01f);
+		}
+		if (FPlatformProcess::IsProcRunning(ProcessHandle))
+		{
+			FPlatformProcess::TerminateProc(ProcessHandle, true);
+		}
+		FPlatformProcess::CloseProc(ProcessHandle);
+	}
+	if (StdInRead || StdInWrite)
+	{
+		FPlatformProcess::ClosePipe(StdInRead, StdInWrite);
+	}
+	if (StdOutRead || StdOutWrite)
+	{
+		FPlatformProcess::ClosePipe(StdOutRead, StdOutWrite);
+	}
+	StdInRead = StdInWrite = StdOutRead = StdOutWrite = nullptr;
+	PendingData.Empty();
+	PendingOffset = 0;
+}
+
+bool FGitCatFileBatch::IsRunning() const
+{
+	FProcHandle Handle = ProcessHandle;
+	return Handle.IsValid() && FPlatformProcess::IsProcRunning(Handle);
+}
+
+bool FGitCatFileBatch::EnsureRunning()
+{
+	return IsRunning() || Start();
+}
+
+bool FGitCatFileBatch::WriteLine(const FString& InLine)
+{
+	FTCHARToUTF8 Converter(*(InLine + TEXT("\n")));
+	int32 Written = 0;
+	if (!FPlatformProcess::WritePipe(StdInWrite, (const uint8*)Converter.Get(), Converter.Length(), &Written) || Written != Converter.Length())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to write to 'git cat-file'"));
+		Stop();
+		return false;
+	}
+	return true;
+}
+
+bool FGitCatFileBatch::ReadMore()
+{
+	// drop consumed output
+	if (PendingOffset > 0)
+	{
+		PendingData.RemoveAt(0, PendingOffset, false);
+		PendingOffset = 0;
+	}
+	while (true)
+	{
+		const bool bRunning = FPlatformProcess::IsProcRunning(ProcessHandle);
+		TArray<uint8> BinaryData;
+		FPlatformProcess::ReadPipeToArray(StdOutRead, BinaryData);
+		if (BinaryData.Num() > 0)
+		{
+			PendingData.Append(MoveTemp(BinaryData));
+			return true;
+		}
+		if (!bRunning)
+		{
+			UE_LOG(LogTemp, Error, TEXT("'git cat-file' exited unexpectedly"));
+			Stop();
+			return false;
+		}
+		FPlatformProcess::Sleep(0.f);
+	}
+}
+
+bool FGitCatFileBatch::ReadLine(FString& OutLine)
+{
+	int32 SearchIndex = PendingOffset;
+	while (true)
+	{
+		for (; SearchIndex < PendingData.Num(); ++SearchIndex)
+		{
+			if (PendingData[SearchIndex] == '\n')
+			{
+				FUTF8ToTCHAR Converter((const ANSICHAR*)PendingData.GetData() + PendingOffset, SearchIndex - PendingOffset);
+				OutLine = FString(Converter.Length(), Converter.Get());
+				PendingOffset = SearchIndex + 1;
+				return true;
+			}
+		}
+		// ReadMore drops consumed output, keep the searched length
+		const int32 SearchedNum = SearchIndex - PendingOffset;
+		if (!ReadMore())
+		{
+			return false;
+		}
+		SearchIndex = PendingOffset + SearchedNum;
+	}
+}
+
+bool FGitCatFileBatch::ReadBytes(int64 InNum, TArray<uint8>& OutBytes)
+{
+	OutBytes.Reset(InNum);
+	while (OutBytes.Num() < InNum)
+	{
+		if (PendingOffset == PendingData.Num() && !ReadMore())
+		{
+			return false;
+		}
+		const int32 Num = (int32)FMath::Min<int64>(InNum - OutBytes.Num(), PendingData.Num() - PendingOffset);
+		OutBytes.Append(PendingData.GetData() + PendingOffset, Num);
+		PendingOffset += Num;
+	}
+	return true;
+}
+
+bool FGitCatFileBatch::ReadHeader(FObjectInfo& OutInfo)
+{
+	// <oid> SP <type> SP <size> or <object> SP missing
+	FString Line;
+	if (!ReadLine(Line))
+	{
+		return false;
+	}
+	TArray<FString> Fields;
+	Line.ParseIntoArray(Fields, TEXT(" "), true);
+	OutInfo = FObjectInfo();
+	if (Fields.Num() == 3 && Fields[2].IsNumeric())
+	{
+		OutInfo.ObjectId = Fields[0];
+		OutInfo.Type = Fields[1];
+		OutInfo.Size = FCString::Atoi64(*Fields[2]);
+	}
+	return true;
+}
+
+bool FGitCatFileBatch::GetObjectInfo(const FString& InObjectName, FObjectInfo& OutInfo)
+{
+	TArray<FObjectInfo> Infos;
+	if (GetObjectsInfo(TArray<FString>{ InObjectName }, Infos))
+	{
+		OutInfo = Infos[0];
+		return OutInfo.Size >= 0;
+	}
+	return false;
+}
+
+bool FGitCatFileBatch::GetObjectsInfo(const TArray<FString>& InObjectNames, TArray<FObjectInfo>& OutInfos)
+{
+	SCOPED_NAMED_EVENT_TEXT("FGitCatFileBatch::GetObjectsInfo", FColor::Red);
+	FScopeLock Lock(&WorkerCS);
+	OutInfos.Reset(InObjectNames.Num());
+	if (!EnsureRunning())
+	{
+		return false;
+	}
+	for (int32 Begin = 0; Begin < InObjectNames.Num(); Begin += MaxPipelinedRequests)
+	{
+		const int32 End = FMath::Min(Begin + MaxPipelinedRequests, InObjectNames.Num());
+		for (int32 Index = Begin; Index < End; ++Index)
+		{
+			if (!WriteLine(InObjectNames[Index]))
+			{
+				return false;
+			}
+		}
+		for (int32 Index = Begin; Index < End; ++Index)
+		{
+			FObjectInfo& Info = OutInfos.AddDefaulted_GetRef();
+			if (!ReadHeader(Info))
+			{
+				return false;
+			}
+			if (Mode != EMode::Check && Info.Size >= 0)
+			{
+				// skip the content and the trailing LF
+				TArray<uint8> Content;
+				if (!ReadBytes(Info.Size + 1, Content))
+				{
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+bool FGitCatFileBatch::GetObjectContent(const FString& InObjectName, TArray<uint8>& OutContent, FObjectInfo* OutInfo)
+{
+	SCOPED_NAMED_EVENT_TEXT("FGitCatFileBatch::GetObjectContent", FColor::Red);
+	check(Mode != EMode::Check);
+	FScopeLock Lock(&WorkerCS);
+	FObjectInfo Info;
+	if (!EnsureRunning() || !WriteLine(InObjectName) || !ReadHeader(Info) || Info.Size < 0)
+	{
+		return false;
+	}
+	TArray<uint8> Terminator;
+	if (!ReadBytes(Info.Size, OutContent) || !ReadBytes(1, Terminator))
+	{
+		return false;
+	}
+	if (OutInfo)
+	{
+		*OutInfo = Info;
+	}
+	return true;
+}
+
+TSharedPtr<FGitCatFileBatch, ESPMode::ThreadSafe> FGitCatFileBatch::Get(const FString& InPathToGitBinary, const FString& InRepositoryRoot, EMode InMode)
+{
+	const FString Key = FString::Printf(TEXT("%d|%s|%s"), (int32)InMode, *InPathToGitBinary, *InRepositoryRoot);
+	FScopeLock Lock(&WorkersCS);
+	if (const TSharedPtr<FGitCatFileBatch, ESPMode::ThreadSafe>* Found = Workers.Find(Key))
+	{
+		return *Found;
+	}
+	TSharedPtr<FGitCatFileBatch, ESPMode::ThreadSafe> Worker = MakeShareable(new FGitCatFileBatch(InPathToGitBinary, InRepositoryRoot, InMode));
+	Workers.Add(Key, Worker);
+	return Worker;
+}
+
+void FGitCatFileBatch::ResetAll()
+{
+	FScopeLock Lock(&WorkersCS);
+	Workers.Empty();
+}
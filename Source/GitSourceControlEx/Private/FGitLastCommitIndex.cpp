@@ -0,0 +1,212 @@
+#include "FGitLastCommitIndex.h"
+#include "GitSourceControlUtils.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	// guard IndexCacheDir and Indexes
+	FCriticalSection IndexesCS;
+	FString IndexCacheDir;
+	TMap<FString, TSharedPtr<FGitLastCommitIndex, ESPMode::ThreadSafe>> Indexes;
+	const TCHAR* CommitLineMark = TEXT("\x01");
+}
+
+bool FGitLastCommitIndex::Init(const FString& InPathToGitBinary, const FString& InWorkDir)
+{
+	GitBinary = InPathToGitBinary;
+	WorkDir = FPaths::ConvertRelativePathToFull(InWorkDir);
+	FPaths::NormalizeDirectoryName(WorkDir);
+	GitSourceControlUtils::FindRootDirectory(WorkDir, RepositoryRoot);
+	RepositoryRoot = FPaths::ConvertRelativePathToFull(RepositoryRoot);
+	FPaths::NormalizeDirectoryName(RepositoryRoot);
+	RepositoryRoot /= TEXT("");
+
+	TArray<FString> Results;
+	TArray<FString> ErrorMessages;
+	const bool bResult = GitSourceControlUtils::RunCommand(TEXT("rev-parse"), GitBinary, RepositoryRoot, TArray<FString>{ TEXT("HEAD") }, TArray<FString>(), Results, ErrorMessages);
+	HeadCommit = (bResult && Results.Num()) ? Results[0].TrimStartAndEnd() : FString();
+	return !HeadCommit.IsEmpty();
+}
+
+bool FGitLastCommitIndex::Walk(const TArray<FString>& InParameters, TSet<FString>* InRemainingFiles)
+{
+	SCOPED_NAMED_EVENT_TEXT("FGitLastCommitIndex::Walk", FColor::Red);
+	TArray<FString> Parameters{
+		FString::Printf(TEXT("--format=%%x01%%H%%x09%%at%%x09%%ae%%x09%%an")),
+		TEXT("--name-only"),
+		HeadCommit.IsEmpty() ? TEXT("HEAD") : HeadCommit
+	};
+	Parameters.Append(InParameters);
+
+	// the newest commit of a file is the first commit contains it
+	FGitLastCommit CurrentCommit;
+	return GitSourceControlUtils::RunCommandStreamed(TEXT("-c core.quotepath=off log"), GitBinary, RepositoryRoot, Parameters,
+		[this, &CurrentCommit, InRemainingFiles](const FString& InLine)->bool
+		{
+			if (InLine.IsEmpty())
+			{
+				return true;
+			}
+			if (InLine.StartsWith(CommitLineMark))
+			{
+				TArray<FString> Fields;
+				InLine.Mid(1).ParseIntoArray(Fields, TEXT("\t"), false);
+				if (Fields.Num() >= 4)
+				{
+					CurrentCommit.CommitId = Fields[0];
+					CurrentCommit.Timestamp = FCString::Atoi64(*Fields[1]);
+					CurrentCommit.UserEmail = Fields[2];
+					CurrentCommit.UserName = Fields[3];
+				}
+				return true;
+			}
+			// keep all files passed by, later queries may hit them without walking again
+			const FString File = GitSourceControlUtils::UnquotePath(InLine);
+			if (!LastCommits.Contains(File))
+			{
+				LastCommits.Add(File, CurrentCommit);
+			}
+			if (!InRemainingFiles)
+			{
+				return true;
+			}
+			InRemainingFiles->Remove(File);
+			return InRemainingFiles->Num() > 0;
+		});
+}
+
+bool FGitLastCommitIndex::Resolve(const TArray<FString>& InFiles)
+{
+	FScopeLock Lock(&IndexCS);
+	TSet<FString> RemainingFiles;
+	for (const auto& File : InFiles)
+	{
+		const FString RepositoryFile = GitSourceControlUtils::ConvertToRepositoryPath(RepositoryRoot, WorkDir, File);
+		if (!RepositoryFile.IsEmpty() && !LastCommits.Contains(RepositoryFile) && !MissingFiles.Contains(RepositoryFile))
+		{
+			RemainingFiles.Add(RepositoryFile);
+		}
+	}
+	if (!RemainingFiles.Num())
+	{
+		return true;
+	}
+	const bool bResult = Walk(TArray<FString>{}, &RemainingFiles);
+	if (bResult)
+	{
+		MissingFiles.Append(RemainingFiles);
+	}
+	return bResult;
+}
+
+bool FGitLastCommitIndex::ResolveAll(const FString& InPathSpec)
+{
+	const FString PathSpec = GitSourceControlUtils::ConvertToRepositoryPath(RepositoryRoot, WorkDir, InPathSpec);
+	FScopeLock Lock(&IndexCS);
+	TArray<FString> Parameters;
+	if (!PathSpec.IsEmpty())
+	{
+		Parameters.Add(TEXT("--"));
+		Parameters.Add(FString::Printf(TEXT("\"%s\""), *PathSpec));
+	}
+	return Walk(Parameters, nullptr);
+}
+
+bool FGitLastCommitIndex::Find(const FString& InFile, FGitLastCommit& OutLastCommit) const
+{
+	const FString RepositoryFile = GitSourceControlUtils::ConvertToRepositoryPath(RepositoryRoot, WorkDir, InFile);
+	FScopeLock Lock(&IndexCS);
+	if (const FGitLastCommit* LastCommit = LastCommits.Find(RepositoryFile))
+	{
+		OutLastCommit = *LastCommit;
+		return true;
+	}
+	return false;
+}
+
+bool FGitLastCommitIndex::Load(const FString& InCacheFile)
+{
+	// first line is HEAD, then File\tCommitId\tTimestamp\tUserEmail\tUserName
+	TArray<FString> Lines;
+	if (HeadCommit.IsEmpty() || !FFileHelper::LoadFileToStringArray(Lines, *InCacheFile) || !Lines.Num() || !Lines[0].Equals(HeadCommit))
+	{
+		return false;
+	}
+	FScopeLock Lock(&IndexCS);
+	for (int32 Index = 1; Index < Lines.Num(); ++Index)
+	{
+		TArray<FString> Fields;
+		Lines[Index].ParseIntoArray(Fields, TEXT("\t"), false);
+		if (Fields.Num() >= 5 && !LastCommits.Contains(Fields[0]))
+		{
+			FGitLastCommit& LastCommit = LastCommits.Add(Fields[0]);
+			LastCommit.CommitId = Fields[1];
+			LastCommit.Timestamp = FCString::Atoi64(*Fields[2]);
+			LastCommit.UserEmail = Fields[3];
+			LastCommit.UserName = Fields[4];
+		}
+	}
+	return true;
+}
+
+bool FGitLastCommitIndex::Save(const FString& InCacheFile) const
+{
+	if (HeadCommit.IsEmpty())
+	{
+		return false;
+	}
+	TArray<FString> Lines;
+	FScopeLock Lock(&IndexCS);
+	Lines.Reserve(LastCommits.Num() + 1);
+	Lines.Add(HeadCommit);
+	for (const auto& LastCommit : LastCommits)
+	{
+		Lines.Add(FString::Printf(TEXT("%s\t%s\t%lld\t%s\t%s"), *LastCommit.Key, *LastCommit.Value.CommitId, LastCommit.Value.Timestamp, *LastCommit.Value.UserEmail, *LastCommit.Value.UserName));
+	}
+	return FFileHelper::SaveStringArrayToFile(Lines, *InCacheFile, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+FString FGitLastCommitIndex::GetCacheFile(const FString& InCacheDir) const
+{
+	return FPaths::Combine(InCacheDir, FString::Printf(TEXT("GitLastCommit_%s.txt"), *FMD5::HashAnsiString(*RepositoryRoot.ToLower())));
+}
+
+TSharedPtr<FGitLastCommitIndex, ESPMode::ThreadSafe> FGitLastCommitIndex::Get(const FString& InPathToGitBinary, const FString& InWorkDir)
+{
+	FString Key = FPaths::ConvertRelativePathToFull(InWorkDir);
+	FPaths::NormalizeDirectoryName(Key);
+	FScopeLock Lock(&IndexesCS);
+	if (const TSharedPtr<FGitLastCommitIndex, ESPMode::ThreadSafe>* Found = Indexes.Find(Key))
+	{
+		return *Found;
+	}
+	TSharedPtr<FGitLastCommitIndex, ESPMode::ThreadSafe> Index = MakeShareable(new FGitLastCommitIndex);
+	if (Index->Init(InPathToGitBinary, Key) && !IndexCacheDir.IsEmpty())
+	{
+		Index->Load(Index->GetCacheFile(IndexCacheDir));
+	}
+	Indexes.Add(Key, Index);
+	return Index;
+}
+
+void FGitLastCommitIndex::SetCacheDir(const FString& InCacheDir)
+{
+	FScopeLock Lock(&IndexesCS);
+	IndexCacheDir = InCacheDir;
+}
+
+void FGitLastCommitIndex::ResetAll()
+{
+	FScopeLock Lock(&IndexesCS);
+	if (!IndexCacheDir.IsEmpty())
+	{
+		for (const auto& Index : Indexes)
+		{
+			Index.Value->Save(Index.Value->GetCacheFile(IndexCacheDir));
+		}
+	}
+	Indexes.Empty();
+}
@@ -0,0 +1,91 @@
+#include "FGitProcessPool.h"
+#include "GitSourceControlUtils.h"
+#include "Async/Async.h"
+#include "Misc/ScopeLock.h"
+
+FGitProcessPool& FGitProcessPool::Get()
+{
+	static FGitProcessPool Pool;
+	return Pool;
+}
+
+void FGitProcessPool::SetMaxConcurrency(int32 InMaxConcurrency)
+{
+	FScopeLock Lock(&QueueCS);
+	MaxConcurrency = FMath::Max(InMaxConcurrency, 1);
+	// one worker for every new slot, running workers only take queued commands after their command finished
+	while (PendingCommands.Num() && RunningNum < MaxConcurrency)
+	{
+		TSharedPtr<FPendingCommand, ESPMode::ThreadSafe> PendingCommand = PendingCommands[0];
+		PendingCommands.RemoveAt(0, 1, false);
+		++RunningNum;
+		Async(EAsyncExecution::ThreadPool, [this, PendingCommand]()
+		{
+			RunPendingCommands(PendingCommand);
+		});
+	}
+}
+
+int32 FGitProcessPool::GetMaxConcurrency() const
+{
+	FScopeLock Lock(&QueueCS);
+	return MaxConcurrency;
+}
+
+TFuture<FGitCommandResult> FGitProcessPool::RunCommandAsync(const FString& InCommand, const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles)
+{
+	TSharedPtr<FPendingCommand, ESPMode::ThreadSafe> PendingCommand = MakeShareable(new FPendingCommand);
+	PendingCommand->Command = InCommand;
+	PendingCommand->PathToGitBinary = InPathToGitBinary;
+	PendingCommand->RepositoryRoot = InRepositoryRoot;
+	PendingCommand->Parameters = InParameters;
+	PendingCommand->Files = InFiles;
+	PendingCommand->Promise = MakeShareable(new TPromise<FGitCommandResult>());
+	TFuture<FGitCommandResult> Future = PendingCommand->Promise->GetFuture();
+
+	bool bStartWorker = false;
+	{
+		FScopeLock Lock(&QueueCS);
+		if (RunningNum < MaxConcurrency)
+		{
+			++RunningNum;
+			bStartWorker = true;
+		}
+		else
+		{
+			PendingCommands.Add(PendingCommand);
+		}
+	}
+	if (bStartWorker)
+	{
+		Async(EAsyncExecution::ThreadPool, [this, PendingCommand]()
+		{
+			RunPendingCommands(PendingCommand);
+		});
+	}
+	return Future;
+}
+
+void FGitProcessPool::RunPendingCommands(TSharedPtr<FPendingCommand, ESPMode::ThreadSafe> InCommand)
+{
+	TSharedPtr<FPendingCommand, ESPMode::ThreadSafe> Command = InCommand;
+	while (Command.IsValid())
+	{
+		FGitCommandResult Result;
+		Result.bSuccess = GitSourceControlUtils::RunCommand(Command->Command, Command->PathToGitBinary, Command->RepositoryRoot, Command->Parameters, Command->Files, Result.Results, Result.ErrorMessages);
+		Command->Promise->SetValue(MoveTemp(Result));
+
+		// the worker exits if the limit was lowered
+		FScopeLock Lock(&QueueCS);
+		if (PendingCommands.Num() && RunningNum <= MaxConcurrency)
+		{
+			Command = PendingCommands[0];
+			PendingCommands.RemoveAt(0, 1, false);
+		}
+		else
+		{
+			Command.Reset();
+			--RunningNum;
+		}
+	}
+}
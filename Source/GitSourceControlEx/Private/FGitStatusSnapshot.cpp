@@ -0,0 +1,92 @@
+#include "FGitStatusSnapshot.h"
+#include "GitSourceControlUtils.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	FCriticalSection SnapshotsCS;
+	TMap<FString, TSharedPtr<const FGitStatusSnapshot, ESPMode::ThreadSafe>> Snapshots;
+}
+
+bool FGitStatusSnapshot::Update(const FString& InPathToGitBinary, const FString& InWorkDir)
+{
+	SCOPED_NAMED_EVENT_TEXT("FGitStatusSnapshot::Update",FColor::Red);
+	WorkDir = FPaths::ConvertRelativePathToFull(InWorkDir);
+	FPaths::NormalizeDirectoryName(WorkDir);
+	FileStatus.Empty();
+
+	// porcelain paths are relative to the root of repository
+	GitSourceControlUtils::FindRootDirectory(WorkDir, RepositoryRoot);
+	RepositoryRoot = FPaths::ConvertRelativePathToFull(RepositoryRoot);
+	FPaths::NormalizeDirectoryName(RepositoryRoot);
+	RepositoryRoot /= TEXT("");
+
+	// -uall: list files in untracked directories, as same as "git status File"
+	TArray<FString> Results;
+	TArray<FString> ErrorMessages;
+	const TArray<FString> Params{
+		TEXT("--porcelain"),
+		TEXT("-uall")
+	};
+	bValid = UFlibSourceControlHelper::RunGitCommand(TEXT("-c core.quotepath=off status"), InPathToGitBinary, RepositoryRoot, Params, Results, ErrorMessages);
+	for (const auto& Line : Results)
+	{
+		FString File;
+		EGitFileStatus Status;
+		if (ParseStatusLine(Line, File, Status) && Status != EGitFileStatus::NoEdit)
+		{
+			FileStatus.Add(File, Status);
+		}
+	}
+	return bValid;
+}
+
+bool FGitStatusSnapshot::ParseStatusLine(const FString& InLine, FString& OutFile, EGitFileStatus& OutStatus)
+{
+	// XY PATH or XY ORIG_PATH -> PATH
+	if (InLine.Len() < 4)
+	{
+		return false;
+	}
+	OutStatus = UFlibSourceControlHelper::ParseFileStatus(InLine.Left(3));
+	OutFile = InLine.Mid(3);
+	const TCHAR X = InLine[0];
+	const TCHAR Y = InLine[1];
+	if (X == TEXT('R') || X == TEXT('C') || Y == TEXT('R') || Y == TEXT('C'))
+	{
+		int32 ArrowIndex = OutFile.Find(TEXT(" -> "), ESearchCase::CaseSensitive, ESearchDir::FromEnd);
+		if (ArrowIndex != INDEX_NONE)
+		{
+			OutFile = OutFile.Mid(ArrowIndex + 4);
+		}
+	}
+	OutFile = GitSourceControlUtils::UnquotePath(OutFile);
+	return !OutFile.IsEmpty();
+}
+
+EGitFileStatus FGitStatusSnapshot::GetFileStatus(const FString& InFile) const
+{
+	const EGitFileStatus* Found = FileStatus.Find(GitSourceControlUtils::ConvertToRepositoryPath(RepositoryRoot, WorkDir, InFile));
+	return Found ? *Found : EGitFileStatus::NoEdit;
+}
+
+TSharedPtr<const FGitStatusSnapshot, ESPMode::ThreadSafe> FGitStatusSnapshot::Get(const FString& InPathToGitBinary, const FString& InWorkDir)
+{
+	FString Key = FPaths::ConvertRelativePathToFull(InWorkDir);
+	FPaths::NormalizeDirectoryName(Key);
+	FScopeLock Lock(&SnapshotsCS);
+	if (const TSharedPtr<const FGitStatusSnapshot, ESPMode::ThreadSafe>* Found = Snapshots.Find(Key))
+	{
+		return *Found;
+	}
+	TSharedPtr<FGitStatusSnapshot, ESPMode::ThreadSafe> Snapshot = MakeShareable(new FGitStatusSnapshot);
+	Snapshot->Update(InPathToGitBinary, Key);
+	Snapshots.Add(Key, Snapshot);
+	return Snapshot;
+}
+
+void FGitStatusSnapshot::ResetAll()
+{
+	FScopeLock Lock(&SnapshotsCS);
+	Snapshots.Empty();
+}
@@ -19,6 +19,37 @@ bool UFlibSourceControlHelper::RunGitCommand(const FString& InCommand, const FSt
 	return UFlibSourceControlHelper::RunGitCommandWithFiles(InCommand, InPathToGitBinary, InRepositoryRoot, InParameters, TArray<FString>{}, OutResults, OutErrorMessages);
 }
 
+TFuture<FGitCommandResult> UFlibSourceControlHelper::RunGitCommandAsync(const FString& InCommand, const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles)
+{
+	return FGitProcessPool::Get().RunCommandAsync(InCommand, InPathToGitBinary, InRepositoryRoot, InParameters, InFiles);
+}
+
+TFuture<FGitCommandResult> UFlibSourceControlHelper::DiffVersionAsync(const FString& InGitBinaey, const FString& InRepoRoot, const FString& InBeginCommitHash, const FString& InEndCommitHash)
+{
+	TArray<FString> DiffParams{
+		InBeginCommitHash + FString(TEXT("...")) + InEndCommitHash,
+		TEXT("--name-only"),
+		TEXT("-r")
+	};
+	return RunGitCommandAsync(FString(TEXT("diff")), InGitBinaey, InRepoRoot, DiffParams);
+}
+
+TFuture<FGitCommandResult> UFlibSourceControlHelper::GitStatusAsync(const FString& InGitBinaey, const FString& InRepoRoot)
+{
+	TArray<FString> Params{
+		TEXT("--short")
+	};
+	return RunGitCommandAsync(FString(TEXT("status")), InGitBinaey, InRepoRoot, Params).Then([](TFuture<FGitCommandResult> Future)
+	{
+		FGitCommandResult Result = Future.Get();
+		for(auto& ChangedFile:Result.Results)
+		{
+			ChangedFile.RemoveAt(0,3);
+		}
+		return Result;
+	});
+}
+
 bool UFlibSourceControlHelper::DiffVersion(const FString& InGitBinaey, const FString& InRepoRoot, const FString& InBeginCommitHash, const FString& InEndCommitHash, TArray<FString>& OutResault, TArray<FString>& OutErrorMessages)
 {
 	TArray<FString> DiffParams{
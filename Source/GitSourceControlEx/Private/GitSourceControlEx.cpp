@@ -1,6 +1,7 @@
 // Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
 
 #include "GitSourceControlEx.h"
+#include "FGitCatFileBatch.h"
 
 #define LOCTEXT_NAMESPACE "FGitSourceControlExModule"
 
@@ -13,6 +14,7 @@ void FGitSourceControlExModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	FGitCatFileBatch::ResetAll();
 }
 
 #undef LOCTEXT_NAMESPACE
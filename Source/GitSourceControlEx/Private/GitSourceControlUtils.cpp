@@ -1,6 +1,7 @@
 // Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
 
 #include "GitSourceControlUtils.h"
+#include "FGitCatFileBatch.h"
 #include "HAL/PlatformProcess.h"
 #include "HAL/PlatformFilemanager.h"
 #include "HAL/FileManager.h"
@@ -780,9 +781,29 @@ namespace GitSourceControlUtils
 				ParseLogResults(Results, OutHistory,InHistoryDepth);
 			}
 		}
+		// Get file (blob) sha1 id and size of all revisions from the shared cat-file worker
+		TSharedPtr<FGitCatFileBatch, ESPMode::ThreadSafe> CatFileBatch = FGitCatFileBatch::Get(InPathToGitBinary, InRepositoryRoot, FGitCatFileBatch::EMode::Check);
+		TArray<FString> ObjectNames;
+		for (const auto& Revision : OutHistory)
+		{
+			ObjectNames.Add(FString::Printf(TEXT("%s:%s"), *Revision->GetRevision(), *Revision->GetFilename()));
+		}
+		TArray<FGitCatFileBatch::FObjectInfo> ObjectInfos;
+		if (ObjectNames.Num() && CatFileBatch->GetObjectsInfo(ObjectNames, ObjectInfos))
+		{
+			for (int32 Index = 0; Index < OutHistory.Num(); ++Index)
+			{
+				if (ObjectInfos[Index].Size >= 0)
+				{
+					OutHistory[Index]->FileHash = ObjectInfos[Index].ObjectId;
+					OutHistory[Index]->FileSize = (int32)ObjectInfos[Index].Size;
+				}
+			}
+			return bResults;
+		}
 		for (auto& Revision : OutHistory)
 		{
-			// Get file (blob) sha1 id and size
+			// fall back on ls-tree if the worker failed
 			TArray<FString> Results;
 			TArray<FString> Parameters;
 			Parameters.Add(TEXT("--long")); // Show object size of blob (file) entries.
@@ -810,6 +831,22 @@ namespace GitSourceControlUtils
 
 		const FGitVersionEx& GitVersion = GetGitVersion(InPathToGitBinary);
 
+		// "cat-file --batch --filters" needs git 2.11, content comes from the shared worker
+		if (GitVersion.bHasCatFileWithFilters && GitVersion.IsGreaterOrEqualThan(2, 11))
+		{
+			TArray<uint8> BinaryFileContent;
+			if (FGitCatFileBatch::Get(InPathToGitBinary, InRepositoryRoot, FGitCatFileBatch::EMode::FilteredContent)->GetObjectContent(InParameter, BinaryFileContent))
+			{
+				if (FFileHelper::SaveArrayToFile(BinaryFileContent, *InDumpFileName))
+				{
+					UE_LOG(LogTemp, Log, TEXT("Writed '%s' (%do)"), *InDumpFileName, BinaryFileContent.Num());
+					return true;
+				}
+				UE_LOG(LogTemp, Error, TEXT("Could not write %s"), *InDumpFileName);
+				return false;
+			}
+		}
+
 		if (!InRepositoryRoot.IsEmpty())
 		{
 			// Specify the working copy (the root) of the git repository (before the command itself)
@@ -894,6 +931,125 @@ namespace GitSourceControlUtils
 
 		return (ReturnCode == 0);
 	}
+
+	bool RunCommandStreamed(const FString& InCommand, const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, TFunctionRef<bool(const FString&)> InLineCallback)
+	{
+		int32 ReturnCode = -1;
+		FString FullCommand;
+		if (!InRepositoryRoot.IsEmpty())
+		{
+			FullCommand = TEXT("-C \"");
+			FullCommand += InRepositoryRoot;
+			FullCommand += TEXT("\" ");
+		}
+		FullCommand += InCommand;
+		for (const auto& Parameter : InParameters)
+		{
+			FullCommand += TEXT(" ");
+			FullCommand += Parameter;
+		}
+
+		void* PipeRead = nullptr;
+		void* PipeWrite = nullptr;
+		verify(FPlatformProcess::CreatePipe(PipeRead, PipeWrite));
+
+		FProcHandle ProcessHandle = FPlatformProcess::CreateProc(*InPathToGitBinary, *FullCommand, false, true, true, nullptr, 0, nullptr, PipeWrite);
+		bool bStopped = false;
+		if (ProcessHandle.IsValid())
+		{
+			// read as bytes, a UTF-8 character may be split by two reads
+			TArray<uint8> PendingData;
+			auto ConsumeLines = [&PendingData, &InLineCallback, &bStopped](bool bFlush)
+			{
+				int32 LineBegin = 0;
+				for (int32 Index = 0; Index < PendingData.Num() && !bStopped; ++Index)
+				{
+					const bool bLastLine = bFlush && (Index == PendingData.Num() - 1) && PendingData[Index] != '\n';
+					if (PendingData[Index] == '\n' || bLastLine)
+					{
+						int32 LineEnd = (PendingData[Index] == '\n') ? Index : Index + 1;
+						if (LineEnd > LineBegin && PendingData[LineEnd - 1] == '\r')
+						{
+							--LineEnd;
+						}
+						FUTF8ToTCHAR Converter((const ANSICHAR*)PendingData.GetData() + LineBegin, LineEnd - LineBegin);
+						bStopped = !InLineCallback(FString(Converter.Length(), Converter.Get()));
+						LineBegin = Index + 1;
+					}
+				}
+				PendingData.RemoveAt(0, FMath::Min(LineBegin, PendingData.Num()), false);
+			};
+
+			bool bRunning = true;
+			while (!bStopped)
+			{
+				bRunning = FPlatformProcess::IsProcRunning(ProcessHandle);
+				TArray<uint8> BinaryData;
+				FPlatformProcess::ReadPipeToArray(PipeRead, BinaryData);
+				if (BinaryData.Num() > 0)
+				{
+					PendingData.Append(MoveTemp(BinaryData));
+					ConsumeLines(false);
+				}
+				else if (!bRunning)
+				{
+					break;
+				}
+				else
+				{
+					FPlatformProcess::Sleep(0.f);
+				}
+			}
+
+			if (bStopped)
+			{
+				// all wanted lines are read, do not wait the rest of output
+				FPlatformProcess::TerminateProc(ProcessHandle, true);
+				ReturnCode = 0;
+			}
+			else
+			{
+				ConsumeLines(true);
+				FPlatformProcess::GetProcReturnCode(ProcessHandle, &ReturnCode);
+			}
+			FPlatformProcess::CloseProc(ProcessHandle);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("Failed to launch 'git %s'"), *InCommand);
+		}
+
+		FPlatformProcess::ClosePipe(PipeRead, PipeWrite);
+		return (ReturnCode == 0);
+	}
+
+	FString ConvertToRepositoryPath(const FString& InRepositoryRoot, const FString& InWorkDir, const FString& InFile)
+	{
+		FString File = InFile;
+		FPaths::NormalizeFilename(File);
+		if (FPaths::IsRelative(File) || !File.StartsWith(InRepositoryRoot))
+		{
+			// relative to work dir, e.g. the file removed the prefix of work dir
+			File.RemoveFromStart(TEXT("/"));
+			const FString FileInWorkDir = FPaths::ConvertRelativePathToFull(InWorkDir, File);
+			if (FileInWorkDir.StartsWith(InRepositoryRoot))
+			{
+				File = FileInWorkDir;
+			}
+		}
+		File.RemoveFromStart(InRepositoryRoot);
+		return File;
+	}
+
+	FString UnquotePath(const FString& InPath)
+	{
+		// path with special characters is quoted in C style
+		if (InPath.Len() >= 2 && InPath.StartsWith(TEXT("\"")) && InPath.EndsWith(TEXT("\"")))
+		{
+			return InPath.Mid(1, InPath.Len() - 2).ReplaceEscapedCharWithChar();
+		}
+		return InPath;
+	}
 }
 /**
  * @brief Extract the relative filename from a Git status result.
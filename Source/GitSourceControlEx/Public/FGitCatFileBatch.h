@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+/**
+ * A long-lived "git cat-file --batch-check" or "--batch" process of a repository.
+ * Objects are queried over pipes, without spawning git and loading the index for every query.
+ * Thread safe, queries of one worker are serialized.
+ */
+class GITSOURCECONTROLEX_API FGitCatFileBatch
+{
+public:
+	enum class EMode : uint8
+	{
+		// --batch-check, object info only
+		Check,
+		// --batch, raw content
+		Content,
+		// --batch --filters, content with smudge filters (Git LFS etc), object name must be rev:path
+		FilteredContent
+	};
+
+	struct FObjectInfo
+	{
+		FString ObjectId;
+		FString Type;
+		int64 Size = -1;
+	};
+
+	FGitCatFileBatch(const FString& InPathToGitBinary, const FString& InRepositoryRoot, EMode InMode);
+	~FGitCatFileBatch();
+
+	bool Start();
+	/** close stdin of git, the process is terminated if it does not exit */
+	void Stop();
+	bool IsRunning()const;
+
+	/**
+	 * @param	InObjectName	Any object name of git, e.g. sha1, rev:path
+	 * @returns false if the object is missing or the worker failed, IsRunning() is false for the latter
+	 */
+	bool GetObjectInfo(const FString& InObjectName, FObjectInfo& OutInfo);
+	/** info of many objects in pipeline, OutInfos[i].Size is -1 if the object is missing */
+	bool GetObjectsInfo(const TArray<FString>& InObjectNames, TArray<FObjectInfo>& OutInfos);
+	/** only for Content and FilteredContent mode */
+	bool GetObjectContent(const FString& InObjectName, TArray<uint8>& OutContent, FObjectInfo* OutInfo = nullptr);
+
+	/** shared worker of the repository, started at first query */
+	static TSharedPtr<FGitCatFileBatch, ESPMode::ThreadSafe> Get(const FString& InPathToGitBinary, const FString& InRepositoryRoot, EMode InMode);
+	/** stop all shared workers */
+	static void ResetAll();
+
+protected:
+	bool EnsureRunning();
+	bool WriteLine(const FString& InLine);
+	bool ReadLine(FString& OutLine);
+	bool ReadBytes(int64 InNum, TArray<uint8>& OutBytes);
+	// read more output of git, false if git exited
+	bool ReadMore();
+	bool ReadHeader(FObjectInfo& OutInfo);
+
+	FString GitBinary;
+	FString RepositoryRoot;
+	EMode Mode;
+	FProcHandle ProcessHandle;
+	void* StdOutRead = nullptr;
+	void* StdOutWrite = nullptr;
+	void* StdInRead = nullptr;
+	void* StdInWrite = nullptr;
+	// output read but not consumed, begin at PendingOffset
+	TArray<uint8> PendingData;
+	int32 PendingOffset = 0;
+	FCriticalSection WorkerCS;
+};
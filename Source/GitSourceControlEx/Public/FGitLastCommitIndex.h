@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+struct FGitLastCommit
+{
+	FString CommitId;
+	FString UserName;
+	FString UserEmail;
+	int64 Timestamp = 0;
+};
+
+/**
+ * Last commit of files in a repository, built by one "git log --name-only" walk from HEAD.
+ * The walk stops as soon as all requested files are found. Thread safe, one walk of an index at the same time.
+ */
+class GITSOURCECONTROLEX_API FGitLastCommitIndex
+{
+public:
+	/**
+	 * Find the last commit of files not resolved yet
+	 * @param	InFiles		absolute or relative to the work dir
+	 * @returns true if the command succeeded
+	 */
+	bool Resolve(const TArray<FString>& InFiles);
+	/** Resolve all files under InPathSpec(relative to the work dir), walk the whole history of the path */
+	bool ResolveAll(const FString& InPathSpec);
+	/** false if not resolved or the file is not in history */
+	bool Find(const FString& InFile, FGitLastCommit& OutLastCommit)const;
+
+	/** the cache is discarded if HEAD changed */
+	bool Load(const FString& InCacheFile);
+	bool Save(const FString& InCacheFile)const;
+
+	/** shared index of the work dir, loaded from cache dir if it's set */
+	static TSharedPtr<FGitLastCommitIndex, ESPMode::ThreadSafe> Get(const FString& InPathToGitBinary, const FString& InWorkDir);
+	/** persist indexes in InCacheDir between runs, empty to disable */
+	static void SetCacheDir(const FString& InCacheDir);
+	/** save indexes to cache dir and drop them */
+	static void ResetAll();
+
+protected:
+	bool Init(const FString& InPathToGitBinary, const FString& InWorkDir);
+	bool Walk(const TArray<FString>& InParameters, TSet<FString>* InRemainingFiles);
+	FString GetCacheFile(const FString& InCacheDir)const;
+
+	FString GitBinary;
+	FString WorkDir;
+	// root of repository with trailing slash
+	FString RepositoryRoot;
+	FString HeadCommit;
+	// path relative to RepositoryRoot
+	TMap<FString, FGitLastCommit> LastCommits;
+	// requested files not found in the whole history
+	TSet<FString> MissingFiles;
+	// guard LastCommits and MissingFiles
+	mutable FCriticalSection IndexCS;
+};
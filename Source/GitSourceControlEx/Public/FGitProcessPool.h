@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "HAL/CriticalSection.h"
+
+struct FGitCommandResult
+{
+	bool bSuccess = false;
+	TArray<FString> Results;
+	TArray<FString> ErrorMessages;
+};
+
+/**
+ * Run git commands asynchronously, at most MaxConcurrency git processes at the same time.
+ * Commands over the limit are queued and run in submission order.
+ */
+class GITSOURCECONTROLEX_API FGitProcessPool
+{
+public:
+	static FGitProcessPool& Get();
+
+	/** less than 1 is treated as 1, queued commands start at once if the limit is raised */
+	void SetMaxConcurrency(int32 InMaxConcurrency);
+	int32 GetMaxConcurrency()const;
+
+	/** same as GitSourceControlUtils::RunCommand */
+	TFuture<FGitCommandResult> RunCommandAsync(const FString& InCommand, const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles = TArray<FString>());
+
+protected:
+	struct FPendingCommand
+	{
+		FString Command;
+		FString PathToGitBinary;
+		FString RepositoryRoot;
+		TArray<FString> Parameters;
+		TArray<FString> Files;
+		TSharedPtr<TPromise<FGitCommandResult>, ESPMode::ThreadSafe> Promise;
+	};
+	// run commands until the queue is empty
+	void RunPendingCommands(TSharedPtr<FPendingCommand, ESPMode::ThreadSafe> InCommand);
+
+	mutable FCriticalSection QueueCS;
+	TArray<TSharedPtr<FPendingCommand, ESPMode::ThreadSafe>> PendingCommands;
+	int32 RunningNum = 0;
+	int32 MaxConcurrency = 4;
+};
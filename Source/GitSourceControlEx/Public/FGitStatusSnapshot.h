@@ -0,0 +1,37 @@
+#pragma once
+
+#include "FlibSourceControlHelper.h"
+#include "CoreMinimal.h"
+
+/**
+ * Status of all changed files in a repository, from one "git status --porcelain" command.
+ * Per-file queries are answered from memory instead of running git for every file.
+ */
+class GITSOURCECONTROLEX_API FGitStatusSnapshot
+{
+public:
+	/**
+	 * Run git status for the repository which contains InWorkDir
+	 * @param	InPathToGitBinary	The path to the Git binary
+	 * @param	InWorkDir			The repository root or any directory in the repository, relative files are based on it
+	 * @returns true if the command succeeded
+	 */
+	bool Update(const FString& InPathToGitBinary, const FString& InWorkDir);
+	bool IsValid()const { return bValid; }
+	/** InFile is absolute or relative to the work dir, same as "git -C WorkDir status File" */
+	EGitFileStatus GetFileStatus(const FString& InFile)const;
+
+	/** shared snapshot of the work dir, run git status at first query */
+	static TSharedPtr<const FGitStatusSnapshot, ESPMode::ThreadSafe> Get(const FString& InPathToGitBinary, const FString& InWorkDir);
+	/** drop all shared snapshots, files status will be queried again */
+	static void ResetAll();
+
+protected:
+	static bool ParseStatusLine(const FString& InLine, FString& OutFile, EGitFileStatus& OutStatus);
+	FString WorkDir;
+	// root of repository with trailing slash
+	FString RepositoryRoot;
+	// path relative to RepositoryRoot, only changed files
+	TMap<FString, EGitFileStatus> FileStatus;
+	bool bValid = false;
+};
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "FGitCommitInfo.h"
+#include "FGitProcessPool.h"
 #include "FGitSourceControlRevisionData.h"
 #include "Math/NumericLimits.h"
 #include "CoreMinimal.h"
@@ -37,6 +38,12 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "GitSourceControlEx|Flib")
 		static bool RunGitCommand(const FString& InCommand, const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages);
 
+	// run in FGitProcessPool, independent commands run concurrently
+	static TFuture<FGitCommandResult> RunGitCommandAsync(const FString& InCommand, const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles = TArray<FString>());
+	static TFuture<FGitCommandResult> DiffVersionAsync(const FString& InGitBinaey, const FString& InRepoRoot, const FString& InBeginCommitHash, const FString& InEndCommitHash);
+	// Results are changed files as same as GitStatus
+	static TFuture<FGitCommandResult> GitStatusAsync(const FString& InGitBinaey, const FString& InRepoRoot);
+
 	UFUNCTION(BlueprintCallable, Category = "GitSourceControlEx|Flib")
 		static bool DiffVersion(const FString& InGitBinaey, const FString& InRepoRoot, const FString& InBeginCommitHash, const FString& InEndCommitHash, TArray<FString>& OutResault, TArray<FString>& OutErrorMessages);
 	UFUNCTION(BlueprintCallable, Category = "GitSourceControlEx|Flib")
@@ -132,5 +132,29 @@ bool GITSOURCECONTROLEX_API RunGetHistory(const FString& InPathToGitBinary, cons
 */
 bool RunDumpToFile(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InParameter, const FString& InDumpFileName);
 
+/**
+ * Run a Git command and read its output line by line while it's running.
+ *
+ * @param	InCommand			The Git command - e.g. log
+ * @param	InPathToGitBinary	The path to the Git binary
+ * @param	InRepositoryRoot	The Git repository from where to run the command
+ * @param	InParameters		The parameters to the Git command
+ * @param	InLineCallback		Called for every line of StdOut, return false to stop reading and terminate the process
+ * @returns true if the command succeeded or was stopped by the callback
+ */
+bool GITSOURCECONTROLEX_API RunCommandStreamed(const FString& InCommand, const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, TFunctionRef<bool(const FString&)> InLineCallback);
+
+/**
+ * Convert a file to the path relative to the repository root, as same as git output.
+ *
+ * @param	InRepositoryRoot	The root of repository with trailing slash
+ * @param	InWorkDir			Relative file is based on it
+ * @param	InFile				Absolute or relative file
+ */
+FString GITSOURCECONTROLEX_API ConvertToRepositoryPath(const FString& InRepositoryRoot, const FString& InWorkDir, const FString& InFile);
+
+/** Remove the C style quotes of path in git output */
+FString GITSOURCECONTROLEX_API UnquotePath(const FString& InPath);
+
 
 }
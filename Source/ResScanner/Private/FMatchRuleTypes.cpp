@@ -146,6 +146,42 @@ FString FMatchedResult::SerializeResult(bool Lite)const
 	return Result;
 }
 
+FMatchedResult FMatchedResult::MergeShards(const TArray<FMatchedResult>& ShardResults)
+{
+	FMatchedResult Result;
+	for(const auto& ShardResult:ShardResults)
+	{
+		// rule not merged yet is inserted after its previous rule in the shard, the scan order is kept even if a shard lacks rules
+		// RuleID is not unique, rules of table and config both start from 0
+		int32 PrevIndex = INDEX_NONE;
+		for(const auto& RuleMatchedInfo:ShardResult.MatchedAssets)
+		{
+			const int32 FoundIndex = Result.MatchedAssets.IndexOfByPredicate([&RuleMatchedInfo](const FRuleMatchedInfo& MatchedInfo)
+			{
+				return MatchedInfo.RuleID == RuleMatchedInfo.RuleID && MatchedInfo.RuleName.Equals(RuleMatchedInfo.RuleName);
+			});
+			if(FoundIndex != INDEX_NONE)
+			{
+				FRuleMatchedInfo& Found = Result.MatchedAssets[FoundIndex];
+				Found.Assets.Append(RuleMatchedInfo.Assets);
+				Found.AssetPackageNames.Append(RuleMatchedInfo.AssetPackageNames);
+				Found.AssetsCommiter.Append(RuleMatchedInfo.AssetsCommiter);
+				PrevIndex = FoundIndex;
+			}
+			else
+			{
+				Result.MatchedAssets.Insert(RuleMatchedInfo,++PrevIndex);
+			}
+		}
+	}
+	// rules without matched assets are only kept for merging
+	Result.MatchedAssets.RemoveAll([](const FRuleMatchedInfo& MatchedInfo)
+	{
+		return !MatchedInfo.Assets.Num() && !MatchedInfo.AssetPackageNames.Num() && !MatchedInfo.AssetsCommiter.Num();
+	});
+	return Result;
+}
+
 bool FMatchedResult::HasValidResult() const
 {
 	return !!MatchedAssets.Num();
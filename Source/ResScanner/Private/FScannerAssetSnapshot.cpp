@@ -0,0 +1,69 @@
+#include "FScannerAssetSnapshot.h"
+#include "Async/ParallelFor.h"
+
+void FScannerAssetSnapshot::Add(const TArray<FAssetData>& Assets,TArray<int32>& OutIndices)
+{
+	SCOPED_NAMED_EVENT_TEXT("FScannerAssetSnapshot::Add",FColor::Red);
+	OutIndices.SetNumUninitialized(Assets.Num());
+	for(int32 AssetIndex = 0;AssetIndex < Assets.Num();++AssetIndex)
+	{
+		const FAssetData& Asset = Assets[AssetIndex];
+		int32* FoundIndex = ObjectPathIndices.Find(Asset.ObjectPath);
+		if(!FoundIndex)
+		{
+			FoundIndex = &ObjectPathIndices.Add(Asset.ObjectPath,ObjectPaths.Num());
+			ObjectPaths.Add(Asset.ObjectPath);
+			PendingAssets.Add(&Asset);
+		}
+		OutIndices[AssetIndex] = *FoundIndex;
+	}
+}
+
+void FScannerAssetSnapshot::Build(const FScannerTextMatcher* InTextMatcher)
+{
+	SCOPED_NAMED_EVENT_TEXT("FScannerAssetSnapshot::Build",FColor::Red);
+	const int32 BeginIndex = BuiltNum;
+	const int32 NewNum = ObjectPaths.Num();
+	LowerAssetNames.SetNum(NewNum);
+	LowerObjectPaths.SetNum(NewNum);
+	PackageNames.SetNum(NewNum);
+	TextMatchBits.SetNum(NewNum);
+	// bits of built assets are not valid for another text matcher
+	const int32 BitsBeginIndex = (InTextMatcher == TextMatcher) ? BeginIndex : 0;
+	TextMatcher = InTextMatcher;
+
+	ParallelFor(NewNum - BitsBeginIndex,[this,BeginIndex,BitsBeginIndex](int32 Offset)
+	{
+		const int32 Index = BitsBeginIndex + Offset;
+		if(Index >= BeginIndex)
+		{
+			const FAssetData& Asset = *PendingAssets[Index - BeginIndex];
+			TCHAR Buffer[NAME_SIZE];
+			int32 Len = FCompiledTextRule::ToLowerBuffer(Asset.AssetName,Buffer,NAME_SIZE);
+			LowerAssetNames[Index] = FString(Len,Buffer);
+			Len = FCompiledTextRule::ToLowerBuffer(Asset.ObjectPath,Buffer,NAME_SIZE);
+			LowerObjectPaths[Index] = FString(Len,Buffer);
+			PackageNames[Index] = Asset.PackageName.ToString();
+		}
+		if(TextMatcher)
+		{
+			TextMatcher->NameMatcher.Match(LowerAssetNames[Index],TextMatchBits[Index].NameBits);
+			TextMatcher->PathMatcher.Match(LowerObjectPaths[Index],TextMatchBits[Index].PathBits);
+		}
+	});
+	PendingAssets.Empty();
+	BuiltNum = NewNum;
+}
+
+void FScannerAssetSnapshot::Reset()
+{
+	ObjectPaths.Empty();
+	LowerAssetNames.Empty();
+	LowerObjectPaths.Empty();
+	PackageNames.Empty();
+	TextMatchBits.Empty();
+	ObjectPathIndices.Empty();
+	PendingAssets.Empty();
+	TextMatcher = nullptr;
+	BuiltNum = 0;
+}
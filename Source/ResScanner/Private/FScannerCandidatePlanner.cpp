@@ -0,0 +1,73 @@
+#include "FScannerCandidatePlanner.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogScannerCandidatePlanner, Log, All);
+
+void FScannerCandidatePlanner::Plan(const TArray<FString>& Signatures)
+{
+	Reset();
+	for(const auto& Signature:Signatures)
+	{
+		++CandidateSets.FindOrAdd(Signature).RemainingRules;
+	}
+}
+
+TSharedPtr<const TArray<FAssetData>> FScannerCandidatePlanner::Acquire(const FString& Signature,TFunctionRef<TArray<FAssetData>()> Query)
+{
+	FCandidateSet* CandidateSet = CandidateSets.Find(Signature);
+	if(!CandidateSet)
+	{
+		++QueryNum;
+		return MakeShared<const TArray<FAssetData>>(Query());
+	}
+	TSharedPtr<const TArray<FAssetData>> Assets = CandidateSet->Assets;
+	if(Assets.IsValid())
+	{
+		++SharedNum;
+	}
+	else
+	{
+		++QueryNum;
+		Assets = MakeShared<const TArray<FAssetData>>(Query());
+		CandidateSet->Assets = Assets;
+	}
+	if(--CandidateSet->RemainingRules <= 0)
+	{
+		CandidateSets.Remove(Signature);
+	}
+	return Assets;
+}
+
+void FScannerCandidatePlanner::Reset()
+{
+	if(QueryNum || SharedNum)
+	{
+		UE_LOG(LogScannerCandidatePlanner,Display,TEXT("candidate query %d times, shared by %d rules."),QueryNum,SharedNum);
+	}
+	CandidateSets.Empty();
+	QueryNum = 0;
+	SharedNum = 0;
+}
+
+FString FScannerCandidatePlanner::GetSignature(const FScannerMatchRule& Rule,bool bGlobalAssets,bool bRegistryAssets,const TMultiMap<FName,TOptional<FString>>& TagsAndValues)
+{
+	FString Signature = FString::Printf(TEXT("%s|%d%d%d%d|"),
+		IsValid(Rule.ScanAssetType) ? *Rule.ScanAssetType->GetPathName() : TEXT("None"),
+		bGlobalAssets,bRegistryAssets,Rule.RecursiveClasses,bGlobalAssets && Rule.bGlobalAssetMustMatchFilter);
+	for(const auto& Filter:Rule.ScanFilters)
+	{
+		Signature += Filter.Path;
+		Signature += TEXT(";");
+	}
+	if(bRegistryAssets)
+	{
+		for(const auto& TagAndValue:TagsAndValues)
+		{
+			Signature += TEXT("|") + TagAndValue.Key.ToString();
+			if(TagAndValue.Value.IsSet())
+			{
+				Signature += TEXT("=") + TagAndValue.Value.GetValue();
+			}
+		}
+	}
+	return Signature;
+}
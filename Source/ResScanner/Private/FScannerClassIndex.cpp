@@ -0,0 +1,61 @@
+#include "FScannerClassIndex.h"
+
+void FScannerClassIndex::Build(const TArray<FAssetData>& Assets)
+{
+	SCOPED_NAMED_EVENT_TEXT("FScannerClassIndex::Build",FColor::Red);
+	for(const auto& Asset:Assets)
+	{
+		AddAssetClass(Asset.AssetClass);
+	}
+}
+
+void FScannerClassIndex::AddAssetClass(FName ClassName)
+{
+	if(AssetClassIDs.Contains(ClassName))
+	{
+		return;
+	}
+	UClass* FoundClass = FindObject<UClass>(ANY_PACKAGE, *ClassName.ToString(), true);
+	AssetClassIDs.Add(ClassName,FoundClass ? AddClass(FoundClass) : INDEX_NONE);
+}
+
+void FScannerClassIndex::Reset()
+{
+	AssetClassIDs.Empty();
+	ClassIDs.Empty();
+	Ancestors.Empty();
+}
+
+int32 FScannerClassIndex::FindClassID(FName AssetClassName) const
+{
+	const int32* FoundID = AssetClassIDs.Find(AssetClassName);
+	return FoundID ? *FoundID : INDEX_NONE;
+}
+
+int32 FScannerClassIndex::FindClassID(const UClass* Class) const
+{
+	const int32* FoundID = ClassIDs.Find(Class);
+	return FoundID ? *FoundID : INDEX_NONE;
+}
+
+int32 FScannerClassIndex::AddClass(const UClass* Class)
+{
+	if(const int32* FoundID = ClassIDs.Find(Class))
+	{
+		return *FoundID;
+	}
+	TBitArray<> ClassAncestors;
+	if(const UClass* SuperClass = Class->GetSuperClass())
+	{
+		ClassAncestors = Ancestors[AddClass(SuperClass)];
+	}
+	const int32 ClassID = Ancestors.Num();
+	while(ClassAncestors.Num() <= ClassID)
+	{
+		ClassAncestors.Add(false);
+	}
+	ClassAncestors[ClassID] = true;
+	Ancestors.Add(MoveTemp(ClassAncestors));
+	ClassIDs.Add(Class,ClassID);
+	return ClassID;
+}
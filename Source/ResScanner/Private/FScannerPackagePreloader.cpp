@@ -0,0 +1,128 @@
+#include "FScannerPackagePreloader.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectHash.h"
+#include "UObject/UObjectIterator.h"
+
+FScannerPackagePreloader::FScannerPackagePreloader(const TArray<FName>& InPackageNames,int32 InPreloadNum)
+	:PackageNames(InPackageNames),PreloadNum(FMath::Max(1,InPreloadNum)),State(MakeShareable(new FPreloadState))
+{
+}
+
+FScannerPackagePreloader::~FScannerPackagePreloader()
+{
+	ReleaseAll();
+}
+
+void FScannerPackagePreloader::Prepare(int32 Index)
+{
+	SCOPED_NAMED_EVENT_TEXT("FScannerPackagePreloader::Prepare",FColor::Red);
+	const int32 RequestEnd = FMath::Min(PackageNames.Num(),Index + PreloadNum + 1);
+	for(;RequestedNum < RequestEnd;++RequestedNum)
+	{
+		const FName PackageName = PackageNames[RequestedNum];
+		if(RequestIDs.Contains(PackageName))
+		{
+			continue;
+		}
+		UPackage* LoadedPackage = FindPackage(nullptr,*PackageName.ToString());
+		if(LoadedPackage && LoadedPackage->IsFullyLoaded())
+		{
+			State->LoadedPackages.Add(PackageName,TStrongObjectPtr<UPackage>(LoadedPackage));
+			RequestIDs.Add(PackageName,INDEX_NONE);
+			continue;
+		}
+		TSharedRef<FPreloadState> InState = State;
+		int32 RequestID = LoadPackageAsync(PackageName.ToString(),FLoadPackageAsyncDelegate::CreateLambda(
+			[InState](const FName& InPackageName,UPackage* InLoadedPackage,EAsyncLoadingResult::Type InResult)
+			{
+				if(InResult == EAsyncLoadingResult::Succeeded && InLoadedPackage)
+				{
+					InState->LoadedPackages.Add(InPackageName,TStrongObjectPtr<UPackage>(InLoadedPackage));
+				}
+			}));
+		RequestIDs.Add(PackageName,RequestID);
+	}
+
+	if(PackageNames.IsValidIndex(Index))
+	{
+		const int32* RequestID = RequestIDs.Find(PackageNames[Index]);
+		if(RequestID && *RequestID != INDEX_NONE && !State->LoadedPackages.Contains(PackageNames[Index]))
+		{
+			FlushAsyncLoading(*RequestID);
+		}
+	}
+}
+
+void FScannerPackagePreloader::Finish(int32 Index)
+{
+	if(!PackageNames.IsValidIndex(Index))
+	{
+		return;
+	}
+	FinishedPackages.Add(PackageNames[Index]);
+	if(FinishedPackages.Num() >= PreloadNum)
+	{
+		ReleaseFinished();
+	}
+}
+
+void FScannerPackagePreloader::ReleaseFinished()
+{
+	for(const auto& PackageName:FinishedPackages)
+	{
+		State->LoadedPackages.Remove(PackageName);
+	}
+	FinishedPackages.Reset();
+}
+
+void FScannerPackagePreloader::ReleaseAll()
+{
+	State->LoadedPackages.Empty();
+	FinishedPackages.Empty();
+}
+
+void FScannerPackageTracker::Begin()
+{
+	SCOPED_NAMED_EVENT_TEXT("FScannerPackageTracker::Begin",FColor::Red);
+	InitialPackages.Empty();
+	for(TObjectIterator<UPackage> It;It;++It)
+	{
+		InitialPackages.Add(It->GetFName());
+	}
+	InitialUsedMemory = FPlatformMemory::GetStats().UsedPhysical;
+}
+
+void FScannerPackageTracker::End()
+{
+	InitialPackages.Empty();
+	InitialUsedMemory = 0;
+}
+
+int32 FScannerPackageTracker::UnloadPackages()
+{
+	SCOPED_NAMED_EVENT_TEXT("FScannerPackageTracker::UnloadPackages",FColor::Red);
+	int32 UnloadNum = 0;
+	for(TObjectIterator<UPackage> It;It;++It)
+	{
+		UPackage* Package = *It;
+		// modified packages are not unloaded, changes of them will be lost
+		if(Package == GetTransientPackage() || Package->IsDirty() || !Package->IsFullyLoaded() || InitialPackages.Contains(Package->GetFName()))
+		{
+			continue;
+		}
+		ForEachObjectWithOuter(Package,[](UObject* Object)
+		{
+			Object->ClearFlags(RF_Standalone);
+		},true);
+		++UnloadNum;
+	}
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	return UnloadNum;
+}
+
+uint64 FScannerPackageTracker::GetUsedMemory() const
+{
+	const uint64 UsedMemory = FPlatformMemory::GetStats().UsedPhysical;
+	return UsedMemory > InitialUsedMemory ? UsedMemory - InitialUsedMemory : 0;
+}
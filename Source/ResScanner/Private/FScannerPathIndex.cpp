@@ -0,0 +1,131 @@
+#include "FScannerPathIndex.h"
+
+void FScannerPathPrefixTrie::Add(const FString& Prefix)
+{
+	// FString::StartsWith of empty string is false, empty prefix matches nothing
+	if(Prefix.IsEmpty())
+	{
+		return;
+	}
+	if(!Nodes.Num())
+	{
+		Nodes.AddDefaulted();
+	}
+	int32 NodeIndex = 0;
+	for(TCHAR Char:Prefix)
+	{
+		const TCHAR LowerChar = FChar::ToLower(Char);
+		int32 ChildIndex = FindChild(NodeIndex,LowerChar);
+		if(ChildIndex == INDEX_NONE)
+		{
+			ChildIndex = Nodes.AddDefaulted();
+			Nodes[NodeIndex].Children.Emplace(LowerChar,ChildIndex);
+		}
+		NodeIndex = ChildIndex;
+	}
+	Nodes[NodeIndex].bTerminal = true;
+}
+
+void FScannerPathPrefixTrie::Add(const TArray<FDirectoryPath>& Directorys)
+{
+	for(const auto& Directory:Directorys)
+	{
+		Add(Directory.Path);
+	}
+}
+
+int32 FScannerPathPrefixTrie::FindChild(int32 NodeIndex,TCHAR Char) const
+{
+	for(const auto& Child:Nodes[NodeIndex].Children)
+	{
+		if(Child.Key == Char)
+		{
+			return Child.Value;
+		}
+	}
+	return INDEX_NONE;
+}
+
+bool FScannerPathPrefixTrie::MatchAnyPrefix(const TCHAR* Text,int32 Len) const
+{
+	if(!Nodes.Num())
+	{
+		return false;
+	}
+	int32 NodeIndex = 0;
+	for(int32 Index = 0;Index < Len;++Index)
+	{
+		if(Nodes[NodeIndex].bTerminal)
+		{
+			return true;
+		}
+		NodeIndex = FindChild(NodeIndex,FChar::ToLower(Text[Index]));
+		if(NodeIndex == INDEX_NONE)
+		{
+			return false;
+		}
+	}
+	return Nodes[NodeIndex].bTerminal;
+}
+
+bool FScannerPathPrefixTrie::MatchAnyPrefix(FName Text) const
+{
+	if(!Nodes.Num())
+	{
+		return false;
+	}
+	TCHAR Buffer[NAME_SIZE];
+	const int32 Len = Text.ToString(Buffer,NAME_SIZE);
+	return MatchAnyPrefix(Buffer,Len);
+}
+
+void FScannerIgnoreIndex::Build(const TArray<FAssetFilters>& IgnoreRules)
+{
+	for(const auto& IgnoreRule:IgnoreRules)
+	{
+		Directorys.Add(IgnoreRule.Filters);
+		for(const auto& Asset:IgnoreRule.Assets)
+		{
+			FString AssetPath = Asset.GetAssetPathString();
+			if(AssetPath.IsEmpty())
+			{
+				continue;
+			}
+			FName AssetPathName = *AssetPath;
+			const FName* FoundName = Assets.Find(AssetPathName);
+			if(!FoundName)
+			{
+				Assets.Add(AssetPathName);
+			}
+			else if(!FoundName->IsEqual(AssetPathName,ENameCase::CaseSensitive))
+			{
+				CaseVariantAssets.AddUnique(AssetPath);
+			}
+		}
+	}
+}
+
+bool FScannerIgnoreIndex::IsIgnored(const FAssetData& AssetData) const
+{
+	if(Directorys.MatchAnyPrefix(AssetData.PackagePath))
+	{
+		return true;
+	}
+	const FName* FoundName = Assets.Find(AssetData.ObjectPath);
+	if(FoundName && FoundName->IsEqual(AssetData.ObjectPath,ENameCase::CaseSensitive))
+	{
+		return true;
+	}
+	if(FoundName && CaseVariantAssets.Num())
+	{
+		FString ObjectPath = AssetData.ObjectPath.ToString();
+		for(const auto& AssetPath:CaseVariantAssets)
+		{
+			if(ObjectPath.Equals(AssetPath))
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
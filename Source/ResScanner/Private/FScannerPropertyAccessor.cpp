@@ -0,0 +1,276 @@
+#include "FScannerPropertyAccessor.h"
+#include "UObject/UnrealType.h"
+#include "UObject/EnumProperty.h"
+
+namespace
+{
+	template<typename T>
+	bool CompareValue(const T& Value,const T& MatchValue,EPropertyMatchRule MatchRule)
+	{
+		switch(MatchRule)
+		{
+		case EPropertyMatchRule::NotEqual:
+			return !(Value == MatchValue);
+		case EPropertyMatchRule::LessThan:
+			return Value < MatchValue;
+		case EPropertyMatchRule::GreaterThan:
+			return Value > MatchValue;
+		default:
+			return Value == MatchValue;
+		}
+	}
+}
+
+const void* FScannerPropertyAccessor::GetValuePtr(const UObject* Object)const
+{
+	const void* ValuePtr = Object;
+	for(const FProperty* Property:PropertyChain)
+	{
+		if(!ValuePtr)
+		{
+			break;
+		}
+		ValuePtr = Property->ContainerPtrToValuePtr<void>(ValuePtr);
+	}
+	return ValuePtr;
+}
+
+int64 FScannerPropertyAccessor::GetEnumValue(const FString& MatchValue)const
+{
+	if(const int64* Found = EnumValues.Find(MatchValue))
+	{
+		return *Found;
+	}
+	int64 Value = Enum ? Enum->GetValueByNameString(MatchValue) : INDEX_NONE;
+	if(Value == INDEX_NONE && MatchValue.IsNumeric())
+	{
+		Value = FCString::Atoi64(*MatchValue);
+	}
+	EnumValues.Add(MatchValue,Value);
+	return Value;
+}
+
+bool FScannerPropertyAccessor::Match(const UObject* Object,const FPropertyMatchMapping& PropertyRule)const
+{
+	const void* ValuePtr = GetValuePtr(Object);
+	if(!ValuePtr || !PropertyChain.Num())
+	{
+		return false;
+	}
+	const FProperty* Property = PropertyChain.Last();
+	const FString& MatchValue = PropertyRule.MatchValue;
+	const EPropertyMatchRule MatchRule = PropertyRule.MatchRule;
+	switch(Kind)
+	{
+	case EScannerPropertyKind::Bool:
+		{
+			const int32 Value = CastFieldChecked<const FBoolProperty>(Property)->GetPropertyValue(ValuePtr) ? 1 : 0;
+			return CompareValue<int32>(Value,FCString::ToBool(*MatchValue) ? 1 : 0,MatchRule);
+		}
+	case EScannerPropertyKind::Integer:
+		{
+			const int64 Value = CastFieldChecked<const FNumericProperty>(Property)->GetSignedIntPropertyValue(ValuePtr);
+			return CompareValue<int64>(Value,FCString::Atoi64(*MatchValue),MatchRule);
+		}
+	case EScannerPropertyKind::Float:
+		{
+			const float Value = (float)CastFieldChecked<const FNumericProperty>(Property)->GetFloatingPointPropertyValue(ValuePtr);
+			return CompareValue<float>(Value,FCString::Atof(*MatchValue),MatchRule);
+		}
+	case EScannerPropertyKind::Double:
+		{
+			const double Value = CastFieldChecked<const FNumericProperty>(Property)->GetFloatingPointPropertyValue(ValuePtr);
+			return CompareValue<double>(Value,FCString::Atod(*MatchValue),MatchRule);
+		}
+	case EScannerPropertyKind::Enum:
+		{
+			const FEnumProperty* EnumProperty = CastField<const FEnumProperty>(Property);
+			const FNumericProperty* NumericProperty = EnumProperty ? EnumProperty->GetUnderlyingProperty() : CastFieldChecked<const FNumericProperty>(Property);
+			const int64 EnumMatchValue = GetEnumValue(MatchValue);
+			if(EnumMatchValue == INDEX_NONE)
+			{
+				// not a name of the enum, same as text compare
+				return MatchRule == EPropertyMatchRule::NotEqual;
+			}
+			return CompareValue<int64>(NumericProperty->GetSignedIntPropertyValue(ValuePtr),EnumMatchValue,MatchRule);
+		}
+	case EScannerPropertyKind::Name:
+		{
+			const FName& Value = *static_cast<const FName*>(ValuePtr);
+			if(MatchRule == EPropertyMatchRule::Equal || MatchRule == EPropertyMatchRule::NotEqual)
+			{
+				const FName MatchName(*MatchValue,FNAME_Find);
+				const bool bEqual = (!MatchName.IsNone() || MatchValue.Equals(TEXT("None"))) && Value.IsEqual(MatchName,ENameCase::CaseSensitive);
+				return (MatchRule == EPropertyMatchRule::Equal) ? bEqual : !bEqual;
+			}
+			return CompareText(Value.ToString(),MatchValue,MatchRule);
+		}
+	case EScannerPropertyKind::String:
+		{
+			const FString& Value = *static_cast<const FString*>(ValuePtr);
+			return !Value.IsEmpty() && CompareText(Value,MatchValue,MatchRule);
+		}
+	case EScannerPropertyKind::Object:
+		{
+			if(MatchRule != EPropertyMatchRule::Equal && MatchRule != EPropertyMatchRule::NotEqual)
+			{
+				return false;
+			}
+			const UObject* Value = CastFieldChecked<const FObjectPropertyBase>(Property)->GetObjectPropertyValue(ValuePtr);
+			bool bEqual = false;
+			if(!Value)
+			{
+				bEqual = MatchValue.Equals(TEXT("None"));
+			}
+			else
+			{
+				// Class'/Game/Path.Object' or /Game/Path.Object
+				FString MatchPath = MatchValue;
+				int32 QuoteIndex = INDEX_NONE;
+				if(MatchPath.FindChar(TEXT('\''),QuoteIndex))
+				{
+					MatchPath = MatchPath.Mid(QuoteIndex + 1);
+					MatchPath.RemoveFromEnd(TEXT("'"));
+				}
+				bEqual = (Value == StaticFindObject(UObject::StaticClass(),nullptr,*MatchPath));
+			}
+			return (MatchRule == EPropertyMatchRule::Equal) ? bEqual : !bEqual;
+		}
+	default:
+		{
+			FString Value;
+			Property->ExportTextItem(Value,ValuePtr,nullptr,nullptr,0);
+			return !Value.IsEmpty() && CompareText(Value,MatchValue,MatchRule);
+		}
+	}
+}
+
+bool FScannerPropertyAccessor::MatchText(const FString& Value,const FPropertyMatchMapping& PropertyRule)const
+{
+	if(Value.IsEmpty())
+	{
+		return false;
+	}
+	const FString& MatchValue = PropertyRule.MatchValue;
+	const EPropertyMatchRule MatchRule = PropertyRule.MatchRule;
+	switch(Kind)
+	{
+	case EScannerPropertyKind::Bool:
+		return CompareValue<int32>(FCString::ToBool(*Value) ? 1 : 0,FCString::ToBool(*MatchValue) ? 1 : 0,MatchRule);
+	case EScannerPropertyKind::Integer:
+		return CompareValue<int64>(FCString::Atoi64(*Value),FCString::Atoi64(*MatchValue),MatchRule);
+	case EScannerPropertyKind::Float:
+		return CompareValue<float>(FCString::Atof(*Value),FCString::Atof(*MatchValue),MatchRule);
+	case EScannerPropertyKind::Double:
+		return CompareValue<double>(FCString::Atod(*Value),FCString::Atod(*MatchValue),MatchRule);
+	case EScannerPropertyKind::Enum:
+		{
+			const int64 EnumValue = GetEnumValue(Value);
+			const int64 EnumMatchValue = GetEnumValue(MatchValue);
+			if(EnumValue != INDEX_NONE && EnumMatchValue != INDEX_NONE)
+			{
+				return CompareValue<int64>(EnumValue,EnumMatchValue,MatchRule);
+			}
+			return CompareText(Value,MatchValue,MatchRule);
+		}
+	default:
+		return CompareText(Value,MatchValue,MatchRule);
+	}
+}
+
+bool FScannerPropertyAccessor::CompareText(const FString& Value,const FString& MatchValue,EPropertyMatchRule MatchRule)
+{
+	switch(MatchRule)
+	{
+	case EPropertyMatchRule::NotEqual:
+		return !Value.Equals(MatchValue);
+	case EPropertyMatchRule::LessThan:
+	case EPropertyMatchRule::GreaterThan:
+		{
+			if(Value.IsNumeric() && MatchValue.IsNumeric())
+			{
+				return CompareValue<double>(FCString::Atod(*Value),FCString::Atod(*MatchValue),MatchRule);
+			}
+			const int32 Result = FCString::Strcmp(*Value,*MatchValue);
+			return (MatchRule == EPropertyMatchRule::LessThan) ? Result < 0 : Result > 0;
+		}
+	default:
+		return Value.Equals(MatchValue);
+	}
+}
+
+const FScannerPropertyAccessor* FScannerPropertyAccessorCache::Find(const UClass* Class,const FString& PropertyPath)
+{
+	if(!Class)
+	{
+		return nullptr;
+	}
+	const TPair<FObjectKey,FString> Key(FObjectKey(Class),PropertyPath);
+	if(const TSharedPtr<FScannerPropertyAccessor>* Found = Accessors.Find(Key))
+	{
+		return Found->Get();
+	}
+
+	TSharedPtr<FScannerPropertyAccessor> Accessor = MakeShareable(new FScannerPropertyAccessor);
+	TArray<FString> PropertyNames;
+	PropertyPath.ParseIntoArray(PropertyNames,TEXT("."));
+	const UStruct* Struct = Class;
+	for(const auto& PropertyName:PropertyNames)
+	{
+		FProperty* Property = Struct ? Struct->FindPropertyByName(FName(*PropertyName)) : nullptr;
+		if(!Property)
+		{
+			Accessor.Reset();
+			break;
+		}
+		Accessor->PropertyChain.Add(Property);
+		FStructProperty* StructProperty = CastField<FStructProperty>(Property);
+		Struct = StructProperty ? StructProperty->Struct : nullptr;
+	}
+
+	if(Accessor.IsValid() && Accessor->PropertyChain.Num())
+	{
+		FProperty* Property = Accessor->PropertyChain.Last();
+		FNumericProperty* NumericProperty = CastField<FNumericProperty>(Property);
+		if(Property->IsA(FBoolProperty::StaticClass()))
+		{
+			Accessor->Kind = EScannerPropertyKind::Bool;
+		}
+		else if(FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+		{
+			Accessor->Kind = EScannerPropertyKind::Enum;
+			Accessor->Enum = EnumProperty->GetEnum();
+		}
+		else if(NumericProperty && NumericProperty->GetIntPropertyEnum())
+		{
+			Accessor->Kind = EScannerPropertyKind::Enum;
+			Accessor->Enum = NumericProperty->GetIntPropertyEnum();
+		}
+		else if(NumericProperty && NumericProperty->IsFloatingPoint())
+		{
+			Accessor->Kind = Property->IsA(FFloatProperty::StaticClass()) ? EScannerPropertyKind::Float : EScannerPropertyKind::Double;
+		}
+		else if(NumericProperty && NumericProperty->IsInteger())
+		{
+			Accessor->Kind = EScannerPropertyKind::Integer;
+		}
+		else if(Property->IsA(FNameProperty::StaticClass()))
+		{
+			Accessor->Kind = EScannerPropertyKind::Name;
+		}
+		else if(Property->IsA(FStrProperty::StaticClass()))
+		{
+			Accessor->Kind = EScannerPropertyKind::String;
+		}
+		else if(Property->IsA(FObjectProperty::StaticClass()))
+		{
+			Accessor->Kind = EScannerPropertyKind::Object;
+		}
+	}
+	else
+	{
+		Accessor.Reset();
+	}
+	Accessors.Add(Key,Accessor);
+	return Accessor.Get();
+}
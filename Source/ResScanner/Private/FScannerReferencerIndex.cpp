@@ -0,0 +1,122 @@
+#include "FScannerReferencerIndex.h"
+#include "AssetRegistryModule.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogScannerReferencerIndex, Log, All);
+
+void FScannerReferencerIndex::Build(IAssetRegistry& AssetRegistry,bool bHardReferences,bool bSoftReferences)
+{
+	SCOPED_NAMED_EVENT_TEXT("FScannerReferencerIndex::Build",FColor::Red);
+	Reset();
+	if(!bHardReferences && !bSoftReferences)
+	{
+		return;
+	}
+	TArray<FAssetData> AllAssets;
+	AssetRegistry.GetAllAssets(AllAssets,true);
+	for(const auto& Asset:AllAssets)
+	{
+		AddPackage(Asset.PackageName);
+	}
+
+#if ENGINE_MAJOR_VERSION > 4 || ENGINE_MINOR_VERSION >= 26
+	const UE::AssetRegistry::FDependencyQuery DependencyQuery(bHardReferences && bSoftReferences ? UE::AssetRegistry::EDependencyQuery::NoRequirements :
+		(bHardReferences ? UE::AssetRegistry::EDependencyQuery::Hard : UE::AssetRegistry::EDependencyQuery::Soft));
+#else
+	const EAssetRegistryDependencyType::Type DependencyType = (EAssetRegistryDependencyType::Type)(
+		(bHardReferences ? EAssetRegistryDependencyType::Hard : 0) | (bSoftReferences ? EAssetRegistryDependencyType::Soft : 0));
+#endif
+	// (dependency, referencer), dependencies not on disk(e.g. deleted) are also indexed
+	TArray<TPair<int32,int32>> Edges;
+	TArray<FName> Dependencies;
+	const int32 SourceNum = Packages.Num();
+	for(int32 ReferencerIndex = 0;ReferencerIndex < SourceNum;++ReferencerIndex)
+	{
+		Dependencies.Reset();
+#if ENGINE_MAJOR_VERSION > 4 || ENGINE_MINOR_VERSION >= 26
+		AssetRegistry.GetDependencies(Packages[ReferencerIndex],Dependencies,UE::AssetRegistry::EDependencyCategory::Package,DependencyQuery);
+#else
+		AssetRegistry.GetDependencies(Packages[ReferencerIndex],Dependencies,DependencyType);
+#endif
+		for(const FName& Dependency:Dependencies)
+		{
+			Edges.Emplace(AddPackage(Dependency),ReferencerIndex);
+		}
+	}
+
+	Offsets.Init(0,Packages.Num() + 1);
+	for(const auto& Edge:Edges)
+	{
+		++Offsets[Edge.Key + 1];
+	}
+	for(int32 Index = 0;Index < Packages.Num();++Index)
+	{
+		Offsets[Index + 1] += Offsets[Index];
+	}
+	Referencers.SetNumUninitialized(Edges.Num());
+	TArray<int32> Cursors(Offsets.GetData(),Packages.Num());
+	for(const auto& Edge:Edges)
+	{
+		Referencers[Cursors[Edge.Key]++] = Edge.Value;
+	}
+	UE_LOG(LogScannerReferencerIndex,Display,TEXT("referencer index of %d packages %d references."),Packages.Num(),Referencers.Num());
+}
+
+void FScannerReferencerIndex::Reset()
+{
+	PackageIndices.Empty();
+	Packages.Empty();
+	Offsets.Empty();
+	Referencers.Empty();
+}
+
+int32 FScannerReferencerIndex::AddPackage(FName PackageName)
+{
+	if(const int32* FoundIndex = PackageIndices.Find(PackageName))
+	{
+		return *FoundIndex;
+	}
+	const int32 PackageIndex = Packages.Add(PackageName);
+	PackageIndices.Add(PackageName,PackageIndex);
+	return PackageIndex;
+}
+
+TArray<FName> FScannerReferencerIndex::Expand(const TArray<FName>& ChangedPackages,int32 MaxDepth) const
+{
+	SCOPED_NAMED_EVENT_TEXT("FScannerReferencerIndex::Expand",FColor::Red);
+	TArray<FName> Result;
+	if(!Referencers.Num())
+	{
+		return Result;
+	}
+	TBitArray<> Visited(false,Packages.Num());
+	TArray<int32> Frontier;
+	for(const FName& ChangedPackage:ChangedPackages)
+	{
+		const int32* FoundIndex = PackageIndices.Find(ChangedPackage);
+		if(FoundIndex && !Visited[*FoundIndex])
+		{
+			Visited[*FoundIndex] = true;
+			Frontier.Add(*FoundIndex);
+		}
+	}
+	TArray<int32> NextFrontier;
+	for(int32 Depth = 0;Depth < MaxDepth && Frontier.Num();++Depth)
+	{
+		NextFrontier.Reset();
+		for(int32 PackageIndex:Frontier)
+		{
+			for(int32 Offset = Offsets[PackageIndex];Offset < Offsets[PackageIndex + 1];++Offset)
+			{
+				const int32 ReferencerIndex = Referencers[Offset];
+				if(!Visited[ReferencerIndex])
+				{
+					Visited[ReferencerIndex] = true;
+					NextFrontier.Add(ReferencerIndex);
+					Result.Add(Packages[ReferencerIndex]);
+				}
+			}
+		}
+		Swap(Frontier,NextFrontier);
+	}
+	return Result;
+}
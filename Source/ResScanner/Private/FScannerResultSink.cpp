@@ -0,0 +1,102 @@
+#include "FScannerResultSink.h"
+#include "HAL/FileManager.h"
+#include "Serialization/JsonWriter.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+
+FScannerFileResultSink::FScannerFileResultSink(const FString& InSaveFile,bool bInRecordCommiter)
+	:SaveFile(InSaveFile),bRecordCommiter(bInRecordCommiter)
+{
+}
+
+FScannerFileResultSink::~FScannerFileResultSink()
+{
+	FScannerFileResultSink::EndScan();
+}
+
+void FScannerFileResultSink::BeginScan()
+{
+	Writer.Reset(IFileManager::Get().CreateFileWriter(*SaveFile,FILEWRITE_AllowRead));
+}
+
+void FScannerFileResultSink::EndScan()
+{
+	if(Writer.IsValid())
+	{
+		Writer->Close();
+		Writer.Reset();
+	}
+}
+
+void FScannerFileResultSink::WriteString(const FString& Content)
+{
+	if(Writer.IsValid())
+	{
+		FTCHARToUTF8 Converter(*Content);
+		Writer->Serialize((void*)Converter.Get(),Converter.Length());
+		Writer->Flush();
+	}
+}
+
+void FScannerNDJsonResultSink::OnRuleMatched(const FRuleMatchedInfo& RuleMatchedInfo)
+{
+	FString Lines;
+	auto WriteLine = [&Lines,&RuleMatchedInfo](const FString& Asset,const FString& Commiter)
+	{
+		FString Line;
+		TSharedRef<TJsonWriter<TCHAR,TCondensedJsonPrintPolicy<TCHAR>>> JsonWriter = TJsonWriterFactory<TCHAR,TCondensedJsonPrintPolicy<TCHAR>>::Create(&Line);
+		JsonWriter->WriteObjectStart();
+		JsonWriter->WriteValue(TEXT("RuleName"),RuleMatchedInfo.RuleName);
+		JsonWriter->WriteValue(TEXT("RuleID"),RuleMatchedInfo.RuleID);
+		JsonWriter->WriteValue(TEXT("Asset"),Asset);
+		JsonWriter->WriteValue(TEXT("Commiter"),Commiter);
+		JsonWriter->WriteObjectEnd();
+		JsonWriter->Close();
+		Lines += Line + TEXT("\n");
+	};
+	if(bRecordCommiter)
+	{
+		for(const auto& AssetCommiter:RuleMatchedInfo.AssetsCommiter)
+		{
+			WriteLine(AssetCommiter.File,AssetCommiter.Commiter);
+		}
+	}
+	else
+	{
+		for(const auto& AssetPackageName:RuleMatchedInfo.AssetPackageNames)
+		{
+			WriteLine(AssetPackageName,TEXT(""));
+		}
+	}
+	WriteString(Lines);
+}
+
+void FScannerLiteResultSink::OnRuleMatched(const FRuleMatchedInfo& RuleMatchedInfo)
+{
+	FString Result = TEXT("-------------------------------------------\n");
+	if(RuleMatchedInfo.AssetPackageNames.Num() || RuleMatchedInfo.AssetsCommiter.Num())
+	{
+		FString Describle = RuleMatchedInfo.RuleDescribe.IsEmpty() ? TEXT(""):FString::Printf(TEXT("(%s)"),*RuleMatchedInfo.RuleDescribe);
+		Result += FString::Printf(TEXT("规则名: %s (%d) %s\n"),*RuleMatchedInfo.RuleName,RuleMatchedInfo.AssetPackageNames.Num(),*Describle);
+	}
+	if(bRecordCommiter)
+	{
+		for(const auto& AssetCommiter:RuleMatchedInfo.AssetsCommiter)
+		{
+			Result += FString::Printf(TEXT("\t%s, %s\n"),*AssetCommiter.File,*AssetCommiter.Commiter);
+		}
+	}
+	else
+	{
+		for(const auto& AssetPackageName:RuleMatchedInfo.AssetPackageNames)
+		{
+			Result += FString::Printf(TEXT("\t%s\n"),*AssetPackageName);
+		}
+	}
+	WriteString(Result);
+}
+
+void FScannerLiteResultSink::EndScan()
+{
+	WriteString(TEXT("-------------------------------------------\n"));
+	FScannerFileResultSink::EndScan();
+}
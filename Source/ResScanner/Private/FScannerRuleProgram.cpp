@@ -0,0 +1,319 @@
+#include "FScannerRuleProgram.h"
+#include "FlibAssetParseHelper.h"
+#include "FScannerTextMatcher.h"
+
+bool FCompiledTextGroup::MatchesWildcard(const TCHAR* Text,int32 TextLen,const TCHAR* Wildcard,int32 WildcardLen)
+{
+	auto IsWild = [](TCHAR Char){ return Char == TEXT('*') || Char == TEXT('?'); };
+	int32 LastWild = WildcardLen - 1;
+	while(LastWild >= 0 && !IsWild(Wildcard[LastWild]))
+	{
+		--LastWild;
+	}
+	if(LastWild == INDEX_NONE)
+	{
+		return TextLen == WildcardLen && !FCString::Strncmp(Text,Wildcard,TextLen);
+	}
+	// literal suffix after the last wildcard
+	const int32 SuffixLen = WildcardLen - LastWild - 1;
+	if(SuffixLen)
+	{
+		if(TextLen < SuffixLen || FCString::Strncmp(Text + TextLen - SuffixLen,Wildcard + LastWild + 1,SuffixLen))
+		{
+			return false;
+		}
+		TextLen -= SuffixLen;
+		WildcardLen -= SuffixLen;
+	}
+	// literal prefix before the first wildcard
+	int32 PrefixLen = 0;
+	while(!IsWild(Wildcard[PrefixLen]))
+	{
+		++PrefixLen;
+	}
+	if(PrefixLen)
+	{
+		if(TextLen < PrefixLen || FCString::Strncmp(Text,Wildcard,PrefixLen))
+		{
+			return false;
+		}
+		Text += PrefixLen;
+		TextLen -= PrefixLen;
+		Wildcard += PrefixLen;
+		WildcardLen -= PrefixLen;
+	}
+	// nothing left after wildcard matches the rest
+	const TCHAR FirstWild = *Wildcard++;
+	--WildcardLen;
+	if(!WildcardLen)
+	{
+		return true;
+	}
+	// as FString::MatchesWildcard recurses on Target.Right(MaxNum - Index):
+	// '*' tries every tail of text, '?' only tries the last char or the empty tail
+	const int32 MaxNum = FMath::Min<int32>(TextLen,FirstWild == TEXT('?') ? 1 : TextLen);
+	for(int32 Index = 0;Index <= MaxNum;++Index)
+	{
+		const int32 RightLen = MaxNum - Index;
+		if(MatchesWildcard(Text + TextLen - RightLen,RightLen,Wildcard,WildcardLen))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FCompiledTextGroup::MatchPattern(ECompiledTextMode MatchMode,const TCHAR* LowerText,int32 Len,const FString& LowerPattern)
+{
+	const int32 PatternLen = LowerPattern.Len();
+	bool bMatchResult = false;
+	switch (MatchMode)
+	{
+	// same as FString::StartsWith/EndsWith, empty pattern matches nothing
+	case ECompiledTextMode::StartWith:
+		{
+			bMatchResult = PatternLen && Len >= PatternLen && !FCString::Strncmp(LowerText,*LowerPattern,PatternLen);
+			break;
+		}
+	case ECompiledTextMode::EndWith:
+		{
+			bMatchResult = PatternLen && Len >= PatternLen && !FCString::Strncmp(LowerText + Len - PatternLen,*LowerPattern,PatternLen);
+			break;
+		}
+	case ECompiledTextMode::Wildcard:
+		{
+			bMatchResult = MatchesWildcard(LowerText,Len,*LowerPattern,PatternLen);
+			break;
+		}
+	}
+	return bMatchResult;
+}
+
+bool FCompiledTextGroup::MatchPattern(ECompiledTextMode MatchMode,const FString& LowerText,const FString& LowerPattern)
+{
+	return MatchPattern(MatchMode,*LowerText,LowerText.Len(),LowerPattern);
+}
+
+bool FCompiledTextGroup::Match(const FString& LowerText) const
+{
+	return Match(*LowerText,LowerText.Len());
+}
+
+bool FCompiledTextGroup::Match(const TCHAR* LowerText,int32 Len) const
+{
+	return MatchBy([this,LowerText,Len](const FCompiledTextPattern& Pattern)
+	{
+		return MatchPattern(MatchMode,LowerText,Len,Pattern.Pattern);
+	});
+}
+
+bool FCompiledTextGroup::Match(const TBitArray<>& MatchedPatterns) const
+{
+	return MatchBy([&MatchedPatterns](const FCompiledTextPattern& Pattern)
+	{
+		return MatchedPatterns[Pattern.PatternID];
+	});
+}
+
+bool FCompiledTextRule::Match(const FString& LowerText) const
+{
+	return Match(*LowerText,LowerText.Len());
+}
+
+bool FCompiledTextRule::Match(const TCHAR* LowerText,int32 Len) const
+{
+	return MatchBy([LowerText,Len](const FCompiledTextGroup& Group){ return Group.Match(LowerText,Len); });
+}
+
+int32 FCompiledTextRule::ToLowerBuffer(FName Name,TCHAR* Buffer,int32 BufferSize)
+{
+	const int32 Len = Name.ToString(Buffer,BufferSize);
+	for(int32 Index = 0;Index < Len;++Index)
+	{
+		Buffer[Index] = FChar::ToLower(Buffer[Index]);
+	}
+	return Len;
+}
+
+bool FCompiledTextRule::Match(const TBitArray<>& MatchedPatterns) const
+{
+	return MatchBy([&MatchedPatterns](const FCompiledTextGroup& Group){ return Group.Match(MatchedPatterns); });
+}
+
+void FCompiledTextRule::RegisterPatterns(FScannerPatternMatcher& Matcher)
+{
+	for(auto& Group:Groups)
+	{
+		for(auto& Pattern:Group.Patterns)
+		{
+			Pattern.PatternID = Matcher.AddPattern(Group.MatchMode,Pattern.Pattern);
+		}
+	}
+}
+
+static void CompileTextPatterns(const TArray<FTextRule>& Rules,FCompiledTextGroup& OutGroup)
+{
+	for(const auto& RuleItem:Rules)
+	{
+		FCompiledTextPattern Pattern;
+		Pattern.Pattern = RuleItem.RuleText.ToLower();
+		Pattern.bReverseCheck = RuleItem.bReverseCheck;
+		OutGroup.Patterns.Add(Pattern);
+	}
+}
+
+FCompiledTextRule FCompiledTextRule::Compile(const FNameMatchRule& NameMatchRule)
+{
+	FCompiledTextRule Result;
+	Result.bReverseCheck = NameMatchRule.bReverseCheck;
+	for(const auto& MatchRule:NameMatchRule.Rules)
+	{
+		FCompiledTextGroup& Group = Result.Groups.AddDefaulted_GetRef();
+		switch (MatchRule.MatchMode)
+		{
+			case ENameMatchMode::StartWith: Group.MatchMode = ECompiledTextMode::StartWith; break;
+			case ENameMatchMode::EndWith: Group.MatchMode = ECompiledTextMode::EndWith; break;
+			case ENameMatchMode::Wildcard: Group.MatchMode = ECompiledTextMode::Wildcard; break;
+		}
+		Group.MatchLogic = MatchRule.MatchLogic;
+		Group.OptionalRuleMatchNum = MatchRule.OptionalRuleMatchNum;
+		CompileTextPatterns(MatchRule.Rules,Group);
+	}
+	return Result;
+}
+
+FCompiledTextRule FCompiledTextRule::Compile(const FPathMatchRule& PathMatchRule)
+{
+	FCompiledTextRule Result;
+	Result.bReverseCheck = PathMatchRule.bReverseCheck;
+	for(const auto& MatchRule:PathMatchRule.Rules)
+	{
+		FCompiledTextGroup& Group = Result.Groups.AddDefaulted_GetRef();
+		switch (MatchRule.MatchMode)
+		{
+			case EPathMatchMode::WithIn: Group.MatchMode = ECompiledTextMode::StartWith; break;
+			case EPathMatchMode::Wildcard: Group.MatchMode = ECompiledTextMode::Wildcard; break;
+		}
+		Group.MatchLogic = MatchRule.MatchLogic;
+		Group.OptionalRuleMatchNum = MatchRule.OptionalRuleMatchNum;
+		CompileTextPatterns(MatchRule.Rules,Group);
+	}
+	return Result;
+}
+
+TSharedPtr<FScannerRuleProgram> FScannerRuleProgram::Compile(const FScannerMatchRule& Rule,int32 RuleID,const FScannerConfig& Config,const TMap<FString,TSharedPtr<IMatchOperator>>& MatchOperators,const TSharedPtr<FScannerTextMatcher>& TextMatcher)
+{
+	SCOPED_NAMED_EVENT_TEXT("FScannerRuleProgram::Compile",FColor::Red);
+	TSharedPtr<FScannerRuleProgram> Program = MakeShareable(new FScannerRuleProgram);
+	Program->Rule = &Rule;
+	Program->RuleID = RuleID;
+	Program->IgnoreIndex.Build(TArray<FAssetFilters>{Config.GlobalIgnoreFilters,Rule.IgnoreFilters});
+
+	Program->NameRule = FCompiledTextRule::Compile(Rule.NameMatchRules);
+	Program->PathRule = FCompiledTextRule::Compile(Rule.PathMatchRules);
+	if(TextMatcher.IsValid())
+	{
+		Program->TextMatcher = TextMatcher;
+		Program->NameRule.RegisterPatterns(TextMatcher->NameMatcher);
+		Program->PathRule.RegisterPatterns(TextMatcher->PathMatcher);
+	}
+
+	for(auto ExOperator:Rule.CustomRules)
+	{
+		if(IsValid(ExOperator))
+		{
+			UOperatorBase* Operator = Cast<UOperatorBase>(ExOperator->GetDefaultObject());
+			if(Operator)
+			{
+				Program->CustomOperators.Add(Operator);
+			}
+			else
+			{
+				UE_LOG(LogFlibAssetParseHelper,Log,TEXT("%s is Invalid UOperatorBase class!"),*ExOperator->GetName());
+			}
+		}
+	}
+
+	if(Rule.CommiterMatchRules.bCheckCommiter)
+	{
+		Program->CommiterRepoDir = UFlibAssetParseHelper::ReplaceMarkPath(Rule.CommiterMatchRules.RepoDir);
+		Program->bCommiterRepoExists = FPaths::DirectoryExists(Program->CommiterRepoDir);
+	}
+
+	// drop operators without any rule
+	for(const auto& Operator:MatchOperators)
+	{
+		if(!Operator.Value->HasRules(Rule))
+		{
+			continue;
+		}
+		if(Operator.Value->IsThreadSafe(Rule))
+		{
+			Program->ParallelOperators.Add(Operator.Value);
+		}
+		else
+		{
+			Program->GameThreadOperators.Add(Operator.Value);
+			Program->bNeedLoadAsset |= Operator.Value->NeedLoadAsset(Rule);
+		}
+	}
+	auto SortByCost = [&Rule](TArray<TSharedPtr<IMatchOperator>>& Operators)
+	{
+		Operators.StableSort([&Rule](const TSharedPtr<IMatchOperator>& L,const TSharedPtr<IMatchOperator>& R)
+		{
+			return L->GetCost(Rule) < R->GetCost(Rule);
+		});
+	};
+	SortByCost(Program->ParallelOperators);
+	SortByCost(Program->GameThreadOperators);
+	return Program;
+}
+
+void FScannerOperatorSelectivity::Init(const TArray<TSharedPtr<IMatchOperator>>& Operators,const FScannerMatchRule& Rule)
+{
+	Order.Reset(Operators.Num());
+	Costs.Reset(Operators.Num());
+	for(int32 Index = 0;Index < Operators.Num();++Index)
+	{
+		Order.Add(Index);
+		Costs.Add((uint8)Operators[Index]->GetCost(Rule));
+	}
+	EvaluatedNum.Init(0,Operators.Num());
+	RejectedNum.Init(0,Operators.Num());
+	AssetNum = 0;
+	Reorder();
+}
+
+void FScannerOperatorSelectivity::Record(int32 OperatorIndex,bool bMatched)
+{
+	++EvaluatedNum[OperatorIndex];
+	if(!bMatched)
+	{
+		++RejectedNum[OperatorIndex];
+	}
+}
+
+void FScannerOperatorSelectivity::FinishAsset()
+{
+	if(++AssetNum % ReorderInterval == 0)
+	{
+		Reorder();
+	}
+}
+
+void FScannerOperatorSelectivity::Reorder()
+{
+	// operator not evaluated yet is treated as 50% reject rate
+	auto GetRejectRate = [this](int32 Index)->float
+	{
+		return EvaluatedNum[Index] ? (float)RejectedNum[Index] / EvaluatedNum[Index] : 0.5f;
+	};
+	Order.StableSort([this,&GetRejectRate](int32 L,int32 R)
+	{
+		if(Costs[L] != Costs[R])
+		{
+			return Costs[L] < Costs[R];
+		}
+		return GetRejectRate(L) > GetRejectRate(R);
+	});
+}
@@ -0,0 +1,263 @@
+#include "FScannerScanCache.h"
+#include "TemplateHelper.hpp"
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/SecureHash.h"
+#include "HAL/FileManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogScannerScanCache, Log, All);
+
+// change it if the matching result of same rule is changed
+static const int32 GScanCacheVersion = 2;
+
+bool FScannerScanCache::Load(const FString& InCacheFile,const FString& InConfigName)
+{
+	SCOPED_NAMED_EVENT_TEXT("FScannerScanCache::Load",FColor::Red);
+	CacheFile = InCacheFile;
+	ConfigName = InConfigName;
+	CacheData = FScanCacheData{};
+	CacheData.Version = GScanCacheVersion;
+	FString CacheContent;
+	if(!FPaths::FileExists(CacheFile) || !FFileHelper::LoadFileToString(CacheContent,*CacheFile))
+	{
+		return false;
+	}
+	FScanCacheData LoadedData;
+	if(!TemplateHelper::TDeserializeJsonStringAsStruct(CacheContent,LoadedData) || LoadedData.Version != GScanCacheVersion)
+	{
+		UE_LOG(LogScannerScanCache,Warning,TEXT("scan cache %s is invalid, discard it."),*CacheFile);
+		return false;
+	}
+	CacheData = MoveTemp(LoadedData);
+	UE_LOG(LogScannerScanCache,Display,TEXT("load scan cache %s, %d packages %d rules."),*CacheFile,CacheData.Packages.Num(),CacheData.Rules.Num());
+	return true;
+}
+
+bool FScannerScanCache::Save()
+{
+	SCOPED_NAMED_EVENT_TEXT("FScannerScanCache::Save",FColor::Red);
+	FlushSharedResults();
+	// drop packages not in this scan, deleted packages are never hashed again
+	for(auto It = CacheData.Packages.CreateIterator();It;++It)
+	{
+		if(!PackageHashes.Contains(FName(*It->Key)))
+		{
+			It.RemoveCurrent();
+		}
+	}
+	FString CacheContent;
+	TemplateHelper::TSerializeStructAsJsonString(CacheData,CacheContent);
+	bool bStatus = FFileHelper::SaveStringToFile(CacheContent,*CacheFile,FFileHelper::EEncodingOptions::ForceUTF8);
+	UE_LOG(LogScannerScanCache,Display,TEXT("save scan cache %s %s."),*CacheFile,bStatus ? TEXT("successd") : TEXT("failed"));
+	return bStatus;
+}
+
+FString FScannerScanCache::GetRuleFingerprint(const FScannerMatchRule& Rule)
+{
+	// commiter is changed by git, not by asset
+	if(Rule.CommiterMatchRules.bCheckCommiter)
+	{
+		return FString();
+	}
+	// custom operator may depend on git, other packages or its code, only the class path is in the fingerprint
+	for(const auto& ExOperator:Rule.CustomRules)
+	{
+		if(IsValid(ExOperator))
+		{
+			return FString();
+		}
+	}
+	FString RuleConfig;
+	TemplateHelper::TSerializeStructAsJsonString(Rule,RuleConfig);
+	return FMD5::HashAnsiString(*FString::Printf(TEXT("%d%s"),GScanCacheVersion,*RuleConfig));
+}
+
+void FScannerScanCache::PreparePackages(const TArray<FAssetData>& Assets)
+{
+	SCOPED_NAMED_EVENT_TEXT("FScannerScanCache::PreparePackages",FColor::Red);
+	struct FPackageFile
+	{
+		FName PackageName;
+		FString Filename;
+		FScanCachePackage Package;
+	};
+	TArray<FPackageFile> PackageFiles;
+	for(const auto& Asset:Assets)
+	{
+		if(PackageHashes.Contains(Asset.PackageName))
+		{
+			continue;
+		}
+		PackageHashes.Add(Asset.PackageName,FString());
+		FString Filename;
+#if ENGINE_MAJOR_VERSION > 4
+		bool bPackageExist = FPackageName::DoesPackageExist(Asset.PackageName.ToString(),&Filename);
+#else
+		bool bPackageExist = FPackageName::DoesPackageExist(Asset.PackageName.ToString(),nullptr,&Filename);
+#endif
+		if(bPackageExist)
+		{
+			FPackageFile& PackageFile = PackageFiles.AddDefaulted_GetRef();
+			PackageFile.PackageName = Asset.PackageName;
+			PackageFile.Filename = Filename;
+		}
+	}
+
+	// only hash file content when size or timestamp changed
+	ParallelFor(PackageFiles.Num(),[this,&PackageFiles](int32 Index)
+	{
+		FPackageFile& PackageFile = PackageFiles[Index];
+		PackageFile.Package.Size = IFileManager::Get().FileSize(*PackageFile.Filename);
+		PackageFile.Package.Timestamp = IFileManager::Get().GetTimeStamp(*PackageFile.Filename).ToString();
+		const FScanCachePackage* CachedPackage = CacheData.Packages.Find(PackageFile.PackageName.ToString());
+		if(CachedPackage && CachedPackage->Size == PackageFile.Package.Size && CachedPackage->Timestamp.Equals(PackageFile.Package.Timestamp))
+		{
+			PackageFile.Package.Hash = CachedPackage->Hash;
+		}
+		else
+		{
+			PackageFile.Package.Hash = LexToString(FMD5Hash::HashFile(*PackageFile.Filename));
+		}
+	});
+
+	for(const auto& PackageFile:PackageFiles)
+	{
+		PackageHashes.Add(PackageFile.PackageName,PackageFile.Package.Hash);
+		CacheData.Packages.Add(PackageFile.PackageName.ToString(),PackageFile.Package);
+	}
+}
+
+bool FScannerScanCache::FindResult(const FString& RuleFingerprint,const FAssetData& Asset,bool& bOutMatched) const
+{
+	const FString* PackageHash = PackageHashes.Find(Asset.PackageName);
+	if(!PackageHash || PackageHash->IsEmpty())
+	{
+		return false;
+	}
+	const FScanCacheRule* CacheRule = CacheData.Rules.Find(RuleFingerprint);
+	const FScanCacheResult* Result = CacheRule ? CacheRule->Results.Find(Asset.ObjectPath.ToString()) : nullptr;
+	if(Result && Result->Hash.Equals(*PackageHash))
+	{
+		bOutMatched = Result->bMatched;
+		return true;
+	}
+	return false;
+}
+
+void FScannerScanCache::AddResult(const FString& RuleFingerprint,const FString& RuleName,const FAssetData& Asset,bool bMatched)
+{
+	if(AddLocalResult(RuleFingerprint,RuleName,Asset,bMatched) && !SharedDir.IsEmpty())
+	{
+		PendingSharedResults.Emplace(GetSharedFile(RuleFingerprint,PackageHashes.FindChecked(Asset.PackageName),Asset.ObjectPath),bMatched);
+	}
+}
+
+bool FScannerScanCache::AddLocalResult(const FString& RuleFingerprint,const FString& RuleName,const FAssetData& Asset,bool bMatched)
+{
+	const FString* PackageHash = PackageHashes.Find(Asset.PackageName);
+	if(!PackageHash || PackageHash->IsEmpty())
+	{
+		return false;
+	}
+	if(!UsedRules.Contains(RuleFingerprint))
+	{
+		UsedRules.Add(RuleFingerprint);
+		// remove results of the old config of this rule, same rule name of other configs is kept
+		for(auto It = CacheData.Rules.CreateIterator();It;++It)
+		{
+			if(It->Value.ConfigName.Equals(ConfigName) && It->Value.RuleName.Equals(RuleName) && !It->Key.Equals(RuleFingerprint))
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+	FScanCacheRule& CacheRule = CacheData.Rules.FindOrAdd(RuleFingerprint);
+	CacheRule.ConfigName = ConfigName;
+	CacheRule.RuleName = RuleName;
+	FScanCacheResult& Result = CacheRule.Results.FindOrAdd(Asset.ObjectPath.ToString());
+	Result.bMatched = bMatched;
+	Result.Hash = *PackageHash;
+	return true;
+}
+
+void FScannerScanCache::SetSharedDir(const FString& InSharedDir)
+{
+	SharedDir = InSharedDir;
+	if(!SharedDir.IsEmpty())
+	{
+		UE_LOG(LogScannerScanCache,Display,TEXT("shared scan cache %s."),*SharedDir);
+	}
+}
+
+FString FScannerScanCache::GetSharedFile(const FString& RuleFingerprint,const FString& PackageHash,FName ObjectPath) const
+{
+	// object path is part of key, name/path rules depend on it
+	const FTCHARToUTF8 Key(*FString::Printf(TEXT("%s|%s|%s"),*RuleFingerprint,*PackageHash,*ObjectPath.ToString()));
+	FMD5 Md5;
+	Md5.Update((const uint8*)Key.Get(),Key.Length());
+	FMD5Hash KeyHash;
+	KeyHash.Set(Md5);
+	const FString KeyString = LexToString(KeyHash);
+	return FPaths::Combine(SharedDir,KeyString.Left(2),KeyString);
+}
+
+void FScannerScanCache::FetchSharedResults(const FString& RuleFingerprint,const FString& RuleName,const TArray<FAssetData>& Assets)
+{
+	if(SharedDir.IsEmpty())
+	{
+		return;
+	}
+	SCOPED_NAMED_EVENT_TEXT("FScannerScanCache::FetchSharedResults",FColor::Red);
+	// INDEX_NONE: not found, 0: not matched, 1: matched
+	TArray<int8> SharedResults;
+	SharedResults.Init(INDEX_NONE,Assets.Num());
+	ParallelFor(Assets.Num(),[this,&RuleFingerprint,&Assets,&SharedResults](int32 Index)
+	{
+		const FAssetData& Asset = Assets[Index];
+		const FString& PackageHash = PackageHashes.FindRef(Asset.PackageName);
+		bool bMatched = false;
+		if(PackageHash.IsEmpty() || FindResult(RuleFingerprint,Asset,bMatched))
+		{
+			return;
+		}
+		FString Content;
+		if(FFileHelper::LoadFileToString(Content,*GetSharedFile(RuleFingerprint,PackageHash,Asset.ObjectPath)) && !Content.IsEmpty())
+		{
+			SharedResults[Index] = Content[0] == TEXT('1') ? 1 : 0;
+		}
+	});
+	for(int32 Index = 0;Index < Assets.Num();++Index)
+	{
+		if(SharedResults[Index] != INDEX_NONE && AddLocalResult(RuleFingerprint,RuleName,Assets[Index],SharedResults[Index] == 1))
+		{
+			++SharedHitNum;
+		}
+	}
+}
+
+void FScannerScanCache::FlushSharedResults()
+{
+	if(SharedDir.IsEmpty())
+	{
+		return;
+	}
+	SCOPED_NAMED_EVENT_TEXT("FScannerScanCache::FlushSharedResults",FColor::Red);
+	ParallelFor(PendingSharedResults.Num(),[this](int32 Index)
+	{
+		const FString& SharedFile = PendingSharedResults[Index].Key;
+		if(IFileManager::Get().FileExists(*SharedFile))
+		{
+			return;
+		}
+		// write to temp file and move, other machines never read a partial file
+		const FString TempFile = FString::Printf(TEXT("%s.%s.tmp"),*SharedFile,*FGuid::NewGuid().ToString());
+		if(FFileHelper::SaveStringToFile(PendingSharedResults[Index].Value ? TEXT("1") : TEXT("0"),*TempFile) && !IFileManager::Get().Move(*SharedFile,*TempFile,true,true))
+		{
+			IFileManager::Get().Delete(*TempFile,false,false,true);
+		}
+	});
+	UE_LOG(LogScannerScanCache,Display,TEXT("shared scan cache hit %d results, write %d results."),SharedHitNum,PendingSharedResults.Num());
+	PendingSharedResults.Empty();
+	SharedHitNum = 0;
+}
@@ -0,0 +1,245 @@
+#include "FScannerTextMatcher.h"
+#include "FlibAssetParseHelper.h"
+#include "FScannerAssetSnapshot.h"
+
+int32 FScannerPatternMatcher::AddPattern(ECompiledTextMode Mode,const FString& LowerPattern)
+{
+	check(!bBuilt);
+	TMap<FString,int32>& ModePatternIDs = PatternIDs[(int32)Mode];
+	if(const int32* FoundID = ModePatternIDs.Find(LowerPattern))
+	{
+		return *FoundID;
+	}
+	const int32 PatternID = Patterns.Emplace(Mode,LowerPattern);
+	ModePatternIDs.Add(LowerPattern,PatternID);
+	return PatternID;
+}
+
+int32 FScannerPatternMatcher::FindChild(const TArray<FNode>& Nodes,int32 NodeIndex,TCHAR Char)
+{
+	for(const auto& Child:Nodes[NodeIndex].Children)
+	{
+		if(Child.Key == Char)
+		{
+			return Child.Value;
+		}
+	}
+	return INDEX_NONE;
+}
+
+int32 FScannerPatternMatcher::AddString(TArray<FNode>& Nodes,const TCHAR* Str,int32 Len,bool bReverse)
+{
+	if(!Nodes.Num())
+	{
+		Nodes.AddDefaulted();
+	}
+	int32 NodeIndex = 0;
+	for(int32 Index = 0;Index < Len;++Index)
+	{
+		const TCHAR Char = Str[bReverse ? Len - Index - 1 : Index];
+		int32 ChildIndex = FindChild(Nodes,NodeIndex,Char);
+		if(ChildIndex == INDEX_NONE)
+		{
+			ChildIndex = Nodes.AddDefaulted();
+			Nodes[NodeIndex].Children.Emplace(Char,ChildIndex);
+		}
+		NodeIndex = ChildIndex;
+	}
+	return NodeIndex;
+}
+
+FString FScannerPatternMatcher::GetLongestLiteral(const FString& WildcardPattern)
+{
+	FString Longest;
+	int32 Begin = 0;
+	for(int32 Index = 0;Index <= WildcardPattern.Len();++Index)
+	{
+		if(Index == WildcardPattern.Len() || WildcardPattern[Index] == TEXT('*') || WildcardPattern[Index] == TEXT('?'))
+		{
+			if(Index - Begin > Longest.Len())
+			{
+				Longest = WildcardPattern.Mid(Begin,Index - Begin);
+			}
+			Begin = Index + 1;
+		}
+	}
+	return Longest;
+}
+
+void FScannerPatternMatcher::Build()
+{
+	SCOPED_NAMED_EVENT_TEXT("FScannerPatternMatcher::Build",FColor::Red);
+	for(int32 PatternID = 0;PatternID < Patterns.Num();++PatternID)
+	{
+		const FString& Pattern = Patterns[PatternID].Value;
+		// empty StartWith/EndWith would be at the root and matches every text, not in trie to keep the bit clear
+		if(Pattern.IsEmpty() && Patterns[PatternID].Key != ECompiledTextMode::Wildcard)
+		{
+			continue;
+		}
+		switch (Patterns[PatternID].Key)
+		{
+		case ECompiledTextMode::StartWith:
+			{
+				PrefixNodes[AddString(PrefixNodes,*Pattern,Pattern.Len(),false)].PatternIDs.Add(PatternID);
+				break;
+			}
+		case ECompiledTextMode::EndWith:
+			{
+				SuffixNodes[AddString(SuffixNodes,*Pattern,Pattern.Len(),true)].PatternIDs.Add(PatternID);
+				break;
+			}
+		case ECompiledTextMode::Wildcard:
+			{
+				FString Literal = GetLongestLiteral(Pattern);
+				if(Literal.IsEmpty())
+				{
+					AlwaysCheckWildcards.Add(PatternID);
+				}
+				else
+				{
+					WildcardNodes[AddString(WildcardNodes,*Literal,Literal.Len(),false)].PatternIDs.Add(PatternID);
+				}
+				break;
+			}
+		}
+	}
+
+	// Aho-Corasick fail links by BFS
+	TArray<int32> Queue;
+	if(WildcardNodes.Num())
+	{
+		for(const auto& Child:WildcardNodes[0].Children)
+		{
+			Queue.Add(Child.Value);
+		}
+	}
+	for(int32 QueueIndex = 0;QueueIndex < Queue.Num();++QueueIndex)
+	{
+		const int32 NodeIndex = Queue[QueueIndex];
+		for(const auto& Child:WildcardNodes[NodeIndex].Children)
+		{
+			int32 Fail = WildcardNodes[NodeIndex].Fail;
+			int32 FailChild = FindChild(WildcardNodes,Fail,Child.Key);
+			while(Fail != 0 && FailChild == INDEX_NONE)
+			{
+				Fail = WildcardNodes[Fail].Fail;
+				FailChild = FindChild(WildcardNodes,Fail,Child.Key);
+			}
+			FNode& ChildNode = WildcardNodes[Child.Value];
+			ChildNode.Fail = FailChild == INDEX_NONE ? 0 : FailChild;
+			const FNode& FailNode = WildcardNodes[ChildNode.Fail];
+			ChildNode.OutputLink = FailNode.PatternIDs.Num() ? ChildNode.Fail : FailNode.OutputLink;
+			Queue.Add(Child.Value);
+		}
+	}
+	bBuilt = true;
+}
+
+void FScannerPatternMatcher::Match(const FString& LowerText,TBitArray<>& OutMatched) const
+{
+	Match(*LowerText,LowerText.Len(),OutMatched);
+}
+
+void FScannerPatternMatcher::Match(const TCHAR* Text,int32 Len,TBitArray<>& OutMatched) const
+{
+	check(bBuilt);
+	OutMatched.Init(false,Patterns.Num());
+
+	auto MatchTrie = [Text,Len,&OutMatched](const TArray<FNode>& Nodes,bool bReverse)
+	{
+		int32 NodeIndex = Nodes.Num() ? 0 : INDEX_NONE;
+		for(int32 Index = 0;NodeIndex != INDEX_NONE;++Index)
+		{
+			for(int32 PatternID:Nodes[NodeIndex].PatternIDs)
+			{
+				OutMatched[PatternID] = true;
+			}
+			if(Index == Len)
+			{
+				break;
+			}
+			NodeIndex = FindChild(Nodes,NodeIndex,Text[bReverse ? Len - Index - 1 : Index]);
+		}
+	};
+	MatchTrie(PrefixNodes,false);
+	MatchTrie(SuffixNodes,true);
+
+	TArray<int32,TInlineAllocator<16>> Candidates(AlwaysCheckWildcards);
+	if(WildcardNodes.Num())
+	{
+		int32 State = 0;
+		for(int32 Index = 0;Index < Len;++Index)
+		{
+			int32 Next = FindChild(WildcardNodes,State,Text[Index]);
+			while(State != 0 && Next == INDEX_NONE)
+			{
+				State = WildcardNodes[State].Fail;
+				Next = FindChild(WildcardNodes,State,Text[Index]);
+			}
+			State = Next == INDEX_NONE ? 0 : Next;
+			for(int32 Output = State;Output != INDEX_NONE;Output = WildcardNodes[Output].OutputLink)
+			{
+				Candidates.Append(WildcardNodes[Output].PatternIDs);
+			}
+		}
+	}
+	TBitArray<TInlineAllocator<4>> Checked(false,Candidates.Num() ? Patterns.Num() : 0);
+	for(int32 PatternID:Candidates)
+	{
+		if(!Checked[PatternID])
+		{
+			Checked[PatternID] = true;
+			const FString& Pattern = Patterns[PatternID].Value;
+			OutMatched[PatternID] = FCompiledTextGroup::MatchesWildcard(Text,Len,*Pattern,Pattern.Len());
+		}
+	}
+}
+
+void FScannerTextMatcher::Build()
+{
+	NameMatcher.Build();
+	PathMatcher.Build();
+}
+
+const FScannerTextMatchBits& FScannerTextMatcher::GetMatchBits(FScannerAssetContext& Context)
+{
+	if(!Context.TextMatchBits.IsValid() && Context.Snapshot)
+	{
+		if(const FScannerTextMatchBits* SnapshotBits = Context.Snapshot->GetMatchBits(Context.SnapshotIndex,this))
+		{
+			return *SnapshotBits;
+		}
+	}
+	if(!Context.TextMatchBits.IsValid())
+	{
+		const FName ObjectPath = Context.AssetData.ObjectPath;
+		{
+			FReadScopeLock ReadLock(CacheLock);
+			if(const auto* Found = MatchBitsCache.Find(ObjectPath))
+			{
+				Context.TextMatchBits = *Found;
+			}
+		}
+		if(!Context.TextMatchBits.IsValid())
+		{
+			TSharedPtr<FScannerTextMatchBits,ESPMode::ThreadSafe> MatchBits = MakeShared<FScannerTextMatchBits,ESPMode::ThreadSafe>();
+			TCHAR Buffer[NAME_SIZE];
+			int32 Len = FCompiledTextRule::ToLowerBuffer(Context.AssetData.AssetName,Buffer,NAME_SIZE);
+			NameMatcher.Match(Buffer,Len,MatchBits->NameBits);
+			Len = FCompiledTextRule::ToLowerBuffer(ObjectPath,Buffer,NAME_SIZE);
+			PathMatcher.Match(Buffer,Len,MatchBits->PathBits);
+			FWriteScopeLock WriteLock(CacheLock);
+			if(const auto* Found = MatchBitsCache.Find(ObjectPath))
+			{
+				Context.TextMatchBits = *Found;
+			}
+			else
+			{
+				Context.TextMatchBits = MatchBits;
+				MatchBitsCache.Add(ObjectPath,MatchBits);
+			}
+		}
+	}
+	return *Context.TextMatchBits;
+}
@@ -2,15 +2,26 @@
 
 
 #include "FlibAssetParseHelper.h"
+#include "FScannerRuleProgram.h"
+#include "FScannerTextMatcher.h"
+#include "FScannerClassIndex.h"
+#include "FScannerPathIndex.h"
+#include "FScannerAssetSnapshot.h"
+#include "FScannerReferencerIndex.h"
 #include "TemplateHelper.hpp"
 
 // engine header
 #include "Async/Async.h"
+#include "Misc/ScopeLock.h"
+#include "Engine/World.h"
 #include "Kismet/KismetStringLibrary.h"
 #include "AssetRegistryModule.h"
 #include "ARFilter.h"
+#include "UObject/EnumProperty.h"
 #include "FlibOperationHelper.h"
 #include "FlibSourceControlHelper.h"
+#include "FGitStatusSnapshot.h"
+#include "FGitLastCommitIndex.h"
 #include "Engine/AssetManager.h"
 #include "Framework/Notifications/NotificationManager.h"
 #include "Widgets/Notifications/SNotificationList.h"
@@ -49,6 +60,7 @@ FProperty* UFlibAssetParseHelper::GetPropertyByName(UObject* Obj, const FString&
 		if(PropertyIter->GetName().Equals(PropertyName))
 		{
 			Result = *PropertyIter;
+			break;
 		}
 		// UE_LOG(LogTemp,Log,TEXT("Property Name: %s"),*PropertyIter->GetName());
 	}
@@ -80,6 +92,25 @@ TArray<FAssetData> UFlibAssetParseHelper::GetAssetsByFiltersByClass(const TArray
 	return UFlibAssetParseHelper::GetAssetsByFilters(Types,FilterDirectorys,bRecursiveClasses);
 }
 
+TArray<FAssetData> UFlibAssetParseHelper::GetAssetsByFiltersByClass(const TArray<UClass*>& AssetTypes, const TArray<FDirectoryPath>& FilterDirectorys, bool bRecursiveClasses,const TMultiMap<FName,TOptional<FString>>& TagsAndValues)
+{
+	SCOPED_NAMED_EVENT_TEXT("GetAssetsByFiltersByClass",FColor::Red);
+	TArray<FString> Types;
+	for(auto& Type:AssetTypes)
+	{
+		if(IsValid(Type))
+		{
+			Types.AddUnique(Type->GetName());
+		}
+	}
+	TArray<FString> FilterPaths;
+	for(const auto& Directory:FilterDirectorys)
+	{
+		FilterPaths.AddUnique(Directory.Path);
+	}
+	return UFlibAssetParseHelper::GetAssetsByFilters(Types,FilterPaths,bRecursiveClasses,TagsAndValues);
+}
+
 TArray<FAssetData> UFlibAssetParseHelper::GetAssetsByFilters(const TArray<FString>& AssetTypes,
                                                              const TArray<FDirectoryPath>& FilterDirectorys, bool bRecursiveClasses)
 {
@@ -93,6 +124,12 @@ TArray<FAssetData> UFlibAssetParseHelper::GetAssetsByFilters(const TArray<FStrin
 
 TArray<FAssetData> UFlibAssetParseHelper::GetAssetsByFilters(const TArray<FString>& AssetTypes,
                                                              const TArray<FString>& FilterPaths, bool bRecursiveClasses)
+{
+	return UFlibAssetParseHelper::GetAssetsByFilters(AssetTypes,FilterPaths,bRecursiveClasses,TMultiMap<FName,TOptional<FString>>{});
+}
+
+TArray<FAssetData> UFlibAssetParseHelper::GetAssetsByFilters(const TArray<FString>& AssetTypes,
+                                                             const TArray<FString>& FilterPaths, bool bRecursiveClasses,const TMultiMap<FName,TOptional<FString>>& TagsAndValues)
 {
 	TArray<FAssetData> result;
 	if(FilterPaths.Num())
@@ -104,6 +141,22 @@ TArray<FAssetData> UFlibAssetParseHelper::GetAssetsByFilters(const TArray<FStrin
 		Filter.bRecursiveClasses = bRecursiveClasses;
 		UFlibAssetParseHelper::GetAssetRegistry().GetAssets(Filter, result);	
 	}
+	// FARFilter::TagsAndValues drops assets without the tag, they are filtered here
+	if(TagsAndValues.Num())
+	{
+		result.RemoveAll([&TagsAndValues](const FAssetData& Asset)
+		{
+			for(const auto& TagAndValue:TagsAndValues)
+			{
+				FString TagValue;
+				if(!Asset.GetTagValue(TagAndValue.Key,TagValue) || !TagAndValue.Value.IsSet() || TagValue.Equals(TagAndValue.Value.GetValue()))
+				{
+					return false;
+				}
+			}
+			return true;
+		});
+	}
 
 	return result;
 }
@@ -145,39 +198,73 @@ TArray<FAssetData> UFlibAssetParseHelper::GetAssetsWithCachedByTypes(const TArra
 TArray<FAssetData> UFlibAssetParseHelper::GetAssetsWithCachedByTypes(const TArray<FAssetData>& CachedAssets,
                                                                      const TArray<FString>& AssetTypes,bool bUseFilter,const TArray<FDirectoryPath>& FilterDirectorys,bool bRecursiveClasses)
 {
+	FScannerClassIndex ClassIndex;
+	if(bRecursiveClasses)
+	{
+		ClassIndex.Build(CachedAssets);
+	}
+	return UFlibAssetParseHelper::GetAssetsWithCachedByTypes(CachedAssets,ClassIndex,AssetTypes,bUseFilter,FilterDirectorys,bRecursiveClasses);
+}
+
+TArray<FAssetData> UFlibAssetParseHelper::GetAssetsWithCachedByTypes(const TArray<FAssetData>& CachedAssets,const FScannerClassIndex& ClassIndex,
+                                                                     const TArray<FString>& AssetTypes,bool bUseFilter,const TArray<FDirectoryPath>& FilterDirectorys,bool bRecursiveClasses)
+{
+	SCOPED_NAMED_EVENT_TEXT("UFlibAssetParseHelper::GetAssetsWithCachedByTypes",FColor::Red);
 	TArray<FAssetData> result;
-	for(const auto& CachedAsset:CachedAssets)
+	if(!AssetTypes.Num())
+	{
+		return result;
+	}
+	// not found type class, all assets is child of it
+	bool bAllTypesMatched = !bRecursiveClasses;
+	TArray<int32> TypeClassIDs;
+	TArray<FName> TypeNames;
+	if(!bAllTypesMatched)
 	{
 		for(const auto& Type:AssetTypes)
 		{
-			bool bCheckChild = true;
-			if(bRecursiveClasses)
+			UClass* FoundClass = FindObject<UClass>(ANY_PACKAGE, *Type, true);
+			if(!FoundClass)
 			{
-				UClass* FoundClass = FindObject<UClass>(ANY_PACKAGE, *Type, true);
-				UClass* CurrentAssetClass = FindObject<UClass>(ANY_PACKAGE, *CachedAsset.AssetClass.ToString(), true);
-				if(FoundClass && CurrentAssetClass)
-				{
-					bCheckChild = CurrentAssetClass->IsChildOf(FoundClass);
-				}
+				bAllTypesMatched = true;
+				break;
+			}
+			TypeClassIDs.Add(ClassIndex.FindClassID(FoundClass));
+			TypeNames.Add(*Type);
+		}
+	}
+	
+	FScannerPathPrefixTrie FilterTrie;
+	if(bUseFilter)
+	{
+		FilterTrie.Add(FilterDirectorys);
+	}
+	TSet<FName> AddedAssets;
+	for(const auto& CachedAsset:CachedAssets)
+	{
+		bool bTypeMatched = bAllTypesMatched;
+		if(!bTypeMatched)
+		{
+			const int32 AssetClassID = ClassIndex.FindClassID(CachedAsset.AssetClass);
+			// not found asset class, it's child of any type
+			bTypeMatched = (AssetClassID == INDEX_NONE);
+			for(int32 TypeIndex = 0;!bTypeMatched && TypeIndex < TypeClassIDs.Num();++TypeIndex)
+			{
+				bTypeMatched = (TypeClassIDs[TypeIndex] != INDEX_NONE && ClassIndex.IsChildOf(AssetClassID,TypeClassIDs[TypeIndex])) ||
+								CachedAsset.AssetClass.IsEqual(TypeNames[TypeIndex],ENameCase::CaseSensitive);
 			}
-			if(CachedAsset.AssetClass.ToString().Equals(Type) || bCheckChild)
+		}
+		if(!bTypeMatched)
+		{
+			continue;
+		}
+		if(!bUseFilter || FilterTrie.MatchAnyPrefix(CachedAsset.PackagePath))
+		{
+			bool bAlreadyAdded = false;
+			AddedAssets.Add(CachedAsset.ObjectPath,&bAlreadyAdded);
+			if(!bAlreadyAdded)
 			{
-				if(bUseFilter)
-				{
-					for(const auto& Filter:FilterDirectorys)
-					{
-						if(CachedAsset.PackagePath.ToString().StartsWith(Filter.Path))
-						{
-							result.AddUnique(CachedAsset);
-							break;
-						}
-					}
-				}
-				else
-				{
-					result.AddUnique(CachedAsset);
-				}
-				break;
+				result.Add(CachedAsset);
 			}
 		}
 	}
@@ -199,11 +286,13 @@ IAssetRegistry& UFlibAssetParseHelper::GetAssetRegistry(bool bSearchAllAssets)
 bool UFlibAssetParseHelper::IsIgnoreAsset(const FAssetData& AssetData, const TArray<FAssetFilters>& IgnoreRules)
 {
 	bool bIsIgnored = false;
+	const FString PackagePath = AssetData.PackagePath.ToString();
+	const FString ObjectPath = AssetData.ObjectPath.ToString();
 	for(const auto& IgnoreRule:IgnoreRules)
 	{
 		for(const auto& Filter: IgnoreRule.Filters)
 		{
-			if(AssetData.PackagePath.ToString().StartsWith(Filter.Path))
+			if(PackagePath.StartsWith(Filter.Path))
 			{
 				bIsIgnored = true;
 				break;
@@ -213,7 +302,7 @@ bool UFlibAssetParseHelper::IsIgnoreAsset(const FAssetData& AssetData, const TAr
 		{
 			for(const auto& Asset: IgnoreRule.Assets)
 			{
-				if(AssetData.ObjectPath.ToString().Equals(Asset.GetAssetPathString()))
+				if(ObjectPath.Equals(Asset.GetAssetPathString()))
 				{
 					bIsIgnored = true;
 				}
@@ -296,14 +385,74 @@ TArray<FSoftObjectPath> UFlibAssetParseHelper::GetAssetsByGitChecker(const FGitC
 {
 	SCOPED_NAMED_EVENT_TEXT("UFlibAssetParseHelper::GetAssetsByGitChecker",FColor::Red);
 	TArray<FSoftObjectPath> ResultAssets;
-	if(GitChecker.bGitCheck && GitChecker.bDiffCommit)
+	if(!GitChecker.bGitCheck)
+	{
+		return ResultAssets;
+	}
+	// diff and status are independent, run them at the same time
+	FGitProcessPool::Get().SetMaxConcurrency(GitChecker.MaxGitProcesses);
+	TFuture<FGitCommandResult> DiffFuture;
+	TFuture<FGitCommandResult> StatusFuture;
+	if(GitChecker.bDiffCommit)
+	{
+		DiffFuture = UFlibSourceControlHelper::DiffVersionAsync(GitBinaryOpt,GitChecker.GetRepoDir(),GitChecker.BeginCommitHash,GitChecker.EndCommitHash);
+	}
+	if(GitChecker.bUncommitFiles)
+	{
+		StatusFuture = UFlibSourceControlHelper::GitStatusAsync(GitBinaryOpt,GitChecker.GetRepoDir());
+	}
+	if(DiffFuture.IsValid())
+	{
+		const FGitCommandResult& DiffResult = DiffFuture.Get();
+		if(DiffResult.bSuccess)
+		{
+			ResultAssets.Append(ParserGitFilesToObjectPaths(DiffResult.Results));
+		}
+	}
+	if(StatusFuture.IsValid())
+	{
+		const FGitCommandResult& StatusResult = StatusFuture.Get();
+		if(StatusResult.bSuccess)
+		{
+			ResultAssets.Append(ParserGitFilesToObjectPaths(FilterPackageFiles(StatusResult.Results)));
+		}
+	}
+	if(GitChecker.bExpandReferencers)
+	{
+		ResultAssets.Append(GetReferencerAssets(ResultAssets,GitChecker));
+	}
+	return ResultAssets;
+}
+
+TArray<FSoftObjectPath> UFlibAssetParseHelper::GetReferencerAssets(const TArray<FSoftObjectPath>& ChangedAssets,const FGitChecker& GitChecker)
+{
+	SCOPED_NAMED_EVENT_TEXT("UFlibAssetParseHelper::GetReferencerAssets",FColor::Red);
+	TArray<FSoftObjectPath> ResultAssets;
+	TArray<FName> ChangedPackages;
+	for(const auto& ChangedAsset:ChangedAssets)
 	{
-		ResultAssets.Append(UFlibAssetParseHelper::GetAssetsByGitCommitHash(GitChecker.GetRepoDir(),GitChecker.BeginCommitHash,GitChecker.EndCommitHash,GitBinaryOpt));
+		ChangedPackages.AddUnique(FName(*ChangedAsset.GetLongPackageName()));
 	}
-	if(GitChecker.bGitCheck && GitChecker.bUncommitFiles)
+	if(!ChangedPackages.Num())
 	{
-		ResultAssets.Append(UFlibAssetParseHelper::GetAssetsByGitStatus(GitChecker.GetRepoDir(),GitBinaryOpt));
+		return ResultAssets;
 	}
+	FScannerReferencerIndex ReferencerIndex;
+	ReferencerIndex.Build(GetAssetRegistry(),GitChecker.bHardReferencers,GitChecker.bSoftReferencers);
+	FARFilter Filter;
+	Filter.PackageNames = ReferencerIndex.Expand(ChangedPackages,FMath::Max(GitChecker.ReferencerDepth,1));
+	Filter.bIncludeOnlyOnDiskAssets = true;
+	if(!Filter.PackageNames.Num())
+	{
+		return ResultAssets;
+	}
+	TArray<FAssetData> ReferencerAssets;
+	GetAssetRegistry().GetAssets(Filter,ReferencerAssets);
+	for(const auto& ReferencerAsset:ReferencerAssets)
+	{
+		ResultAssets.Emplace(ReferencerAsset.ObjectPath.ToString());
+	}
+	UE_LOG(LogFlibAssetParseHelper,Display,TEXT("%d changed packages are referenced by %d packages %d assets."),ChangedPackages.Num(),Filter.PackageNames.Num(),ResultAssets.Num());
 	return ResultAssets;
 }
 
@@ -312,6 +461,17 @@ TArray<FSoftObjectPath> UFlibAssetParseHelper::GetAssetsByGitStatus(const FStrin
 	const FString& GitBinaryOpt)
 {
 	SCOPED_NAMED_EVENT_TEXT("GetAssetsByGitStatus",FColor::Red);
+	TArray<FSoftObjectPath> ResultAssets;
+	TArray<FString> GitUnCommitFiles;
+	if(UFlibSourceControlHelper::GitStatus(GitBinaryOpt,RepoDir,GitUnCommitFiles))
+	{
+		ResultAssets.Append(ParserGitFilesToObjectPaths(FilterPackageFiles(GitUnCommitFiles)));
+	}
+	return ResultAssets;
+}
+
+TArray<FString> UFlibAssetParseHelper::FilterPackageFiles(const TArray<FString>& Files)
+{
 	auto IsUasset = [](const FString& File)->bool
 	{
 		TArray<FString> Extersions = {
@@ -329,22 +489,15 @@ TArray<FSoftObjectPath> UFlibAssetParseHelper::GetAssetsByGitStatus(const FStrin
 		}
 		return bResult;
 	};
-	
-	TArray<FSoftObjectPath> ResultAssets;
-	TArray<FString> GitUnCommitFiles;
-	if(UFlibSourceControlHelper::GitStatus(GitBinaryOpt,RepoDir,GitUnCommitFiles))
+	TArray<FString> Assets;
+	for(const auto& File:Files)
 	{
-		TArray<FString> Assets;
-		for(const auto& UnCommitFile:GitUnCommitFiles)
+		if(IsUasset(File))
 		{
-			if(IsUasset(UnCommitFile))
-			{
-				Assets.AddUnique(UnCommitFile);
-			}
+			Assets.AddUnique(File);
 		}
-		ResultAssets.Append(ParserGitFilesToObjectPaths(Assets));
 	}
-	return ResultAssets;
+	return Assets;
 }
 
 TArray<FSoftObjectPath> UFlibAssetParseHelper::GetAssetsByGitCommitHash(const FString& RepoDir,
@@ -364,22 +517,55 @@ TArray<FSoftObjectPath> UFlibAssetParseHelper::GetAssetsByGitCommitHash(const FS
 void UFlibAssetParseHelper::CheckMatchedAssetsCommiter(FMatchedResult& MatchedResult, const FString& RepoDir)
 {
 	SCOPED_NAMED_EVENT_TEXT("UFlibAssetParseHelper::CheckMatchedAssetsCommiter",FColor::Red);
+	TMap<FString,EGitFileStatus> FilesStatus;
+	TArray<FString> NoEditFiles;
+	TArray<FString> AssetPackageNames;
+	for(const auto& MatchedInfo:MatchedResult.GetMatchedInfo())
+	{
+		// commiter is recorded when the rule is emitted
+		if(MatchedInfo.AssetsCommiter.Num())
+		{
+			continue;
+		}
+		for(const auto& AssetPackageName:MatchedInfo.AssetPackageNames)
+		{
+			if(!FilesStatus.Contains(AssetPackageName))
+			{
+				FilesStatus.Add(AssetPackageName,EGitFileStatus::NoEdit);
+				AssetPackageNames.Add(AssetPackageName);
+			}
+		}
+	}
+	if(!AssetPackageNames.Num())
+	{
+		return;
+	}
+	TSharedPtr<const FGitStatusSnapshot,ESPMode::ThreadSafe> StatusSnapshot = FGitStatusSnapshot::Get(TEXT("git"),RepoDir);
+	// convert to repo path, by asset registry without loading packages
+	const TArray<FString> FilesInRepo = GetPackageFilenamesByLongPackageNames(AssetPackageNames);
+	for(int32 Index = 0;Index < AssetPackageNames.Num();++Index)
+	{
+		EGitFileStatus FileStatus = StatusSnapshot->GetFileStatus(FilesInRepo[Index]);
+		FilesStatus[AssetPackageNames[Index]] = FileStatus;
+		if(FileStatus == EGitFileStatus::NoEdit)
+		{
+			NoEditFiles.Add(FilesInRepo[Index]);
+		}
+	}
+	// last commit of all unchanged files by one git log walk
+	FGitLastCommitIndex::Get(TEXT("git"),RepoDir)->Resolve(NoEditFiles);
+	
 	for(auto& MatchedInfo:MatchedResult.GetMatchedInfo())
 	{
+		if(MatchedInfo.AssetsCommiter.Num())
+		{
+			continue;
+		}
 		for(const auto& AssetPackageName:MatchedInfo.AssetPackageNames)
 		{
 			FFileCommiter FileCommiter;
-
-			// convert to repo path
-			FString FileInRepo;
-			FString PackageExtension = GetPackageExtensionByLongPackageName(AssetPackageName);
-			FPackageName::TryConvertLongPackageNameToFilename(AssetPackageName,FileInRepo,*PackageExtension);
-			FileInRepo = FPaths::ConvertRelativePathToFull(FileInRepo);
-			
-			EGitFileStatus FileStatus = UFlibSourceControlHelper::GetFileStatus(TEXT("git"),RepoDir,FileInRepo);
-
 			bool bGetStatus = false;
-			if(FileStatus == EGitFileStatus::NoEdit)
+			if(FilesStatus[AssetPackageName] == EGitFileStatus::NoEdit)
 			{
 				bGetStatus = UFlibAssetParseHelper::GetGitCommiterByLongPackageName(RepoDir,AssetPackageName,FileCommiter);
 			}
@@ -422,37 +608,116 @@ bool UFlibAssetParseHelper::GetLongPackageNameByObject(UObject* Obj, FString& Ou
 	}
 	return bResult;
 }
+namespace
+{
+	FCriticalSection PackageExtensionsCS;
+	// long package name to .umap or .uasset
+	TMap<FString,FString> PackageExtensions;
+}
+
 FString UFlibAssetParseHelper::GetPackageExtensionByLongPackageName(const FString& LongPackageName)
 {
-	FSoftObjectPath AssetObjectPaht = LongPackageNameToPackagePath(LongPackageName);
-	FString PackageExtension = FPackageName::GetAssetPackageExtension();
+	return GetPackageExtensionsByLongPackageNames(TArray<FString>{LongPackageName})[0];
+}
+
+TArray<FString> UFlibAssetParseHelper::GetPackageExtensionsByLongPackageNames(const TArray<FString>& LongPackageNames)
+{
+	SCOPED_NAMED_EVENT_TEXT("UFlibAssetParseHelper::GetPackageExtensionsByLongPackageNames",FColor::Red);
+	TArray<FString> Extensions;
+	Extensions.SetNum(LongPackageNames.Num());
+	TMap<FString,int32> UnresolvedPackages;
 	{
-		UPackage* Package = FindPackage(NULL, *AssetObjectPaht.GetAssetPathString());
-		if (Package)
+		FScopeLock Lock(&PackageExtensionsCS);
+		for(int32 Index = 0;Index < LongPackageNames.Num();++Index)
 		{
-			Package->FullyLoad();
+			if(const FString* Found = PackageExtensions.Find(LongPackageNames[Index]))
+			{
+				Extensions[Index] = *Found;
+			}
+			else
+			{
+				UnresolvedPackages.Add(LongPackageNames[Index],Index);
+			}
 		}
-		else
+	}
+	if(!UnresolvedPackages.Num())
+	{
+		return Extensions;
+	}
+
+	// map package flag of on-disk assets from asset registry, all packages by one query
+	TMap<FString,FString> ResolvedExtensions;
+	FARFilter Filter;
+	Filter.bIncludeOnlyOnDiskAssets = true;
+	for(const auto& UnresolvedPackage:UnresolvedPackages)
+	{
+		Filter.PackageNames.Add(*UnresolvedPackage.Key);
+	}
+	TArray<FAssetData> AssetDatas;
+	UFlibAssetParseHelper::GetAssetRegistry().GetAssets(Filter,AssetDatas);
+	for(const auto& AssetData:AssetDatas)
+	{
+		const bool bContainsMap = !!(AssetData.PackageFlags & PKG_ContainsMap) || AssetData.AssetClass == UWorld::StaticClass()->GetFName();
+		FString& Extension = ResolvedExtensions.FindOrAdd(AssetData.PackageName.ToString());
+		if(bContainsMap || Extension.IsEmpty())
 		{
-			Package = LoadPackage(NULL, *AssetObjectPaht.GetAssetPathString(), LOAD_None);
+			Extension = bContainsMap ? FPackageName::GetMapPackageExtension() : FPackageName::GetAssetPackageExtension();
 		}
-		if(Package)
+	}
+	
+	FScopeLock Lock(&PackageExtensionsCS);
+	for(const auto& UnresolvedPackage:UnresolvedPackages)
+	{
+		FString Extension;
+		if(const FString* Found = ResolvedExtensions.Find(UnresolvedPackage.Key))
+		{
+			Extension = *Found;
+		}
+		else
 		{
-			PackageExtension = Package->ContainsMap() ? FPackageName::GetMapPackageExtension() : FPackageName::GetAssetPackageExtension();
+			// not in asset registry, find the file on disk
+			FString Filename;
+#if ENGINE_MAJOR_VERSION > 4
+			const bool bExist = FPackageName::DoesPackageExist(UnresolvedPackage.Key,&Filename);
+#else
+			const bool bExist = FPackageName::DoesPackageExist(UnresolvedPackage.Key,nullptr,&Filename);
+#endif
+			Extension = (bExist && Filename.EndsWith(FPackageName::GetMapPackageExtension())) ? FPackageName::GetMapPackageExtension() : FPackageName::GetAssetPackageExtension();
 		}
+		PackageExtensions.Add(UnresolvedPackage.Key,Extension);
+		Extensions[UnresolvedPackage.Value] = Extension;
 	}
-	return PackageExtension;
+	return Extensions;
+}
+
+FString UFlibAssetParseHelper::GetPackageFilenameByLongPackageName(const FString& LongPackageName)
+{
+	return GetPackageFilenamesByLongPackageNames(TArray<FString>{LongPackageName})[0];
+}
+
+TArray<FString> UFlibAssetParseHelper::GetPackageFilenamesByLongPackageNames(const TArray<FString>& LongPackageNames)
+{
+	TArray<FString> Filenames = GetPackageExtensionsByLongPackageNames(LongPackageNames);
+	for(int32 Index = 0;Index < LongPackageNames.Num();++Index)
+	{
+		FString Filename;
+		FPackageName::TryConvertLongPackageNameToFilename(LongPackageNames[Index],Filename,*Filenames[Index]);
+		Filenames[Index] = Filename.IsEmpty() ? Filename : FPaths::ConvertRelativePathToFull(Filename);
+	}
+	return Filenames;
+}
+
+void UFlibAssetParseHelper::ResetPackageExtensionCache()
+{
+	FScopeLock Lock(&PackageExtensionsCS);
+	PackageExtensions.Empty();
 }
 
 bool UFlibAssetParseHelper::GetGitOperatorLongPackageName(const FString& RepoDir, const FString& LongPackageName,
 	FFileCommiter& FileCommiter, FGitOperatorCallback callback)
 {
 	bool bResult = false;
-	FString RealFile;
-	FString PackageExtension = GetPackageExtensionByLongPackageName(LongPackageName);
-	FPackageName::TryConvertLongPackageNameToFilename(LongPackageName,RealFile,*PackageExtension);
-			
-	RealFile = FPaths::ConvertRelativePathToFull(RealFile);
+	FString RealFile = GetPackageFilenameByLongPackageName(LongPackageName);
 	if(!RealFile.IsEmpty())
 	{
 		RealFile.RemoveFromStart(RepoDir);
@@ -466,8 +731,17 @@ bool UFlibAssetParseHelper::GetGitCommiterByLongPackageName(const FString& RepoD
 	return GetGitOperatorLongPackageName(RepoDir,LongPackageName,FileCommiter,
 		[](const FString& GitBinary,const FString& RepoDir,const FString& LongPackageName,const FString& FileInRepo,FFileCommiter& FileCommiter)->bool
 		{
+			// resolve the file and all files passed by on the walk
+			TSharedPtr<FGitLastCommitIndex,ESPMode::ThreadSafe> LastCommitIndex = FGitLastCommitIndex::Get(GitBinary,RepoDir);
+			LastCommitIndex->Resolve(TArray<FString>{FileInRepo});
 			FGitSourceControlRevisionData Data;
-			if(UFlibSourceControlHelper::GetFileLastCommitByGlobalGit(RepoDir,FileInRepo,Data))
+			FGitLastCommit LastCommit;
+			if(LastCommitIndex->Find(FileInRepo,LastCommit))
+			{
+				FileCommiter.File = LongPackageName;
+				FileCommiter.Commiter = LastCommit.UserName;
+			}
+			else if(UFlibSourceControlHelper::GetFileLastCommitByGlobalGit(RepoDir,FileInRepo,Data))
 			{
 				FileCommiter.File = LongPackageName;
 				FileCommiter.Commiter = Data.UserName;
@@ -488,7 +762,7 @@ bool UFlibAssetParseHelper::GetLocalEditorByLongPackageName(const FString& RepoD
 		[](const FString& GitBinary,const FString& RepoDir,const FString& LongPackageName,const FString& FileInRepo,FFileCommiter& FileCommiter)->bool
 		{
 			bool bStatus = false;
-			EGitFileStatus GitFileStatus = UFlibSourceControlHelper::GetFileStatus(TEXT("git"),RepoDir,FileInRepo);
+			EGitFileStatus GitFileStatus = FGitStatusSnapshot::Get(GitBinary,RepoDir)->GetFileStatus(FileInRepo);
 			if(GitFileStatus != EGitFileStatus::NoEdit)
 			{
 				FileCommiter.File = LongPackageName;
@@ -499,217 +773,331 @@ bool UFlibAssetParseHelper::GetLocalEditorByLongPackageName(const FString& RepoD
 	});
 }
 
+bool IMatchOperator::Match(FScannerAssetContext& Context,const FScannerRuleProgram& Program)
+{
+	return Match(Context,*Program.Rule);
+}
+
 bool NameMatchOperator::Match(const FAssetData& AssetData,const FScannerMatchRule& Rule)
 {
-	bool bIsMatched = true;
-	FString AssetName = AssetData.AssetName.ToString();
-	for(const auto& MatchRule:Rule.NameMatchRules.Rules)
+	TCHAR Buffer[NAME_SIZE];
+	const int32 Len = FCompiledTextRule::ToLowerBuffer(AssetData.AssetName,Buffer,NAME_SIZE);
+	return FCompiledTextRule::Compile(Rule.NameMatchRules).Match(Buffer,Len);
+}
+
+bool NameMatchOperator::Match(FScannerAssetContext& Context,const FScannerRuleProgram& Program)
+{
+	if(Program.NameRule.IsEmpty())
 	{
-		int32 OptionalMatchNum = 0;
-		for(const auto& RuleItem:MatchRule.Rules)
-		{
-			bool bMatchResult = false;
-			switch (MatchRule.MatchMode)
-			{
-			case ENameMatchMode::StartWith:
-				{
-					bMatchResult = AssetName.StartsWith(RuleItem.RuleText);
-					break;
-				}
-			case ENameMatchMode::EndWith:
-				{
-					bMatchResult = AssetName.EndsWith(RuleItem.RuleText);
-					break;
-				}
-			case ENameMatchMode::Wildcard:
-				{
-					bMatchResult = AssetName.MatchesWildcard(RuleItem.RuleText,ESearchCase::IgnoreCase);
-					break;
-				}
-			}
-			if(RuleItem.bReverseCheck)
-			{
-				bMatchResult = !bMatchResult;
-			}
-			
-			if(bMatchResult)
-			{
-				OptionalMatchNum++;
-			}
-		}
-		bool bIsMatchAllRules = (OptionalMatchNum == MatchRule.Rules.Num());
-		// Optional中匹配成功的数量必须与配置的一致
-		bIsMatched = (MatchRule.MatchLogic == EMatchLogic::Necessary) ? bIsMatchAllRules : (MatchRule.OptionalRuleMatchNum == OptionalMatchNum);
-		if(!bIsMatched)
-		{
-			break;
-		}
+		return true;
 	}
-	if(Rule.NameMatchRules.Rules.Num())
+	if(Program.TextMatcher.IsValid())
 	{
-		bIsMatched = Rule.NameMatchRules.bReverseCheck ? !bIsMatched : bIsMatched;
+		return Program.NameRule.Match(Program.TextMatcher->GetMatchBits(Context).NameBits);
 	}
-	return bIsMatched;
+	if(Context.Snapshot)
+	{
+		return Program.NameRule.Match(Context.GetLowerAssetName());
+	}
+	TCHAR Buffer[NAME_SIZE];
+	const int32 Len = FCompiledTextRule::ToLowerBuffer(Context.AssetData.AssetName,Buffer,NAME_SIZE);
+	return Program.NameRule.Match(Buffer,Len);
 }
+
 bool PathMatchOperator::Match(const FAssetData& AssetData,const FScannerMatchRule& Rule)
+{
+	TCHAR Buffer[NAME_SIZE];
+	const int32 Len = FCompiledTextRule::ToLowerBuffer(AssetData.ObjectPath,Buffer,NAME_SIZE);
+	return FCompiledTextRule::Compile(Rule.PathMatchRules).Match(Buffer,Len);
+}
+
+bool PathMatchOperator::Match(FScannerAssetContext& Context,const FScannerRuleProgram& Program)
+{
+	if(Program.PathRule.IsEmpty())
+	{
+		return true;
+	}
+	if(Program.TextMatcher.IsValid())
+	{
+		return Program.PathRule.Match(Program.TextMatcher->GetMatchBits(Context).PathBits);
+	}
+	if(Context.Snapshot)
+	{
+		return Program.PathRule.Match(Context.GetLowerObjectPath());
+	}
+	TCHAR Buffer[NAME_SIZE];
+	const int32 Len = FCompiledTextRule::ToLowerBuffer(Context.AssetData.ObjectPath,Buffer,NAME_SIZE);
+	return Program.PathRule.Match(Buffer,Len);
+}
+
+UObject* FScannerAssetContext::GetAsset()
+{
+	if(!bLoaded)
+	{
+		LoadedAsset = AssetData.GetAsset();
+		bLoaded = true;
+	}
+	return LoadedAsset;
+}
+
+void FScannerAssetContext::Release()
+{
+	LoadedAsset = nullptr;
+	bLoaded = false;
+}
+
+const FString& FScannerAssetContext::GetLowerAssetName()
+{
+	if(Snapshot)
+	{
+		return Snapshot->LowerAssetNames[SnapshotIndex];
+	}
+	if(LowerAssetName.IsEmpty())
+	{
+		LowerAssetName = AssetData.AssetName.ToString().ToLower();
+	}
+	return LowerAssetName;
+}
+
+const FString& FScannerAssetContext::GetLowerObjectPath()
+{
+	if(Snapshot)
+	{
+		return Snapshot->LowerObjectPaths[SnapshotIndex];
+	}
+	if(LowerObjectPath.IsEmpty())
+	{
+		LowerObjectPath = AssetData.ObjectPath.ToString().ToLower();
+	}
+	return LowerObjectPath;
+}
+
+bool PropertyMatchOperator::Match(const FAssetData& AssetData,const FScannerMatchRule& Rule)
+{
+	FScannerAssetContext Context(AssetData);
+	return Match(Context,Rule);
+}
+
+bool PropertyMatchOperator::Match(FScannerAssetContext& Context,const FScannerMatchRule& Rule)
 {
 	bool bIsMatched = true;
-	FString AssetPath = AssetData.ObjectPath.ToString();
-	for(const auto& MatchRule:Rule.PathMatchRules.Rules)
+	for(const auto& MatchRule:Rule.PropertyMatchRules.MatchRules)
 	{
 		int32 OptionalMatchNum = 0;
-		for(const auto& RuleItem:MatchRule.Rules)
+		for(const auto& PropertyRule:MatchRule.Rules)
 		{
-			bool bMatchResult = false;
-			switch (MatchRule.MatchMode)
-			{
-			case EPathMatchMode::WithIn:
-				{
-					bMatchResult = AssetPath.StartsWith(RuleItem.RuleText);
-					break;
-				}
-			case EPathMatchMode::Wildcard:
-				{
-					bMatchResult = AssetPath.MatchesWildcard(RuleItem.RuleText,ESearchCase::IgnoreCase);
-					break;
-				}
-			}
-			if(RuleItem.bReverseCheck)
-			{
-				bMatchResult = !bMatchResult;
-			}
-			if(bMatchResult)
+			if(MatchProperty(Context,PropertyRule))
 			{
 				OptionalMatchNum++;
 			}
 		}
 		bool bIsMatchAllRules = (OptionalMatchNum == MatchRule.Rules.Num());
+		// Optional中匹配成功的数量必须与配置的一致
 		bIsMatched = (MatchRule.MatchLogic == EMatchLogic::Necessary) ? bIsMatchAllRules : (MatchRule.OptionalRuleMatchNum == OptionalMatchNum);
 		if(!bIsMatched)
 		{
 			break;
 		}
 	}
-	if(Rule.PathMatchRules.Rules.Num())
+	if(Rule.PropertyMatchRules.MatchRules.Num())
 	{
-		bIsMatched = Rule.PathMatchRules.bReverseCheck ? !bIsMatched : bIsMatched;
+		bIsMatched = Rule.PropertyMatchRules.bReverseCheck ? !bIsMatched : bIsMatched;
 	}
 	return bIsMatched;
 }
 
-bool PropertyMatchOperator::Match(const FAssetData& AssetData,const FScannerMatchRule& Rule)
+bool PropertyMatchOperator::MatchProperty(FScannerAssetContext& Context,const FPropertyMatchMapping& PropertyRule)
 {
-	bool bIsMatched = true;
-	UObject* Asset = NULL;
-	if(!!Rule.PropertyMatchRules.MatchRules.Num())
+	// AssetRegistrySearchable property is exported to tag as same as ExportTextItem
+	FString TagValue;
+	if(Context.AssetData.GetTagValue(FName(*PropertyRule.PropertyName),TagValue))
 	{
-		Asset  = AssetData.GetAsset();
+		const FScannerPropertyAccessor* Accessor = AccessorCache.Find(Context.AssetData.GetClass(),PropertyRule.PropertyName);
+		if(Accessor)
+		{
+			return Accessor->MatchText(TagValue,PropertyRule);
+		}
+		return !TagValue.IsEmpty() && FScannerPropertyAccessor::CompareText(TagValue,PropertyRule.MatchValue,PropertyRule.MatchRule);
 	}
+	UObject* Asset = Context.GetAsset();
+	const FScannerPropertyAccessor* Accessor = Asset ? AccessorCache.Find(Asset->GetClass(),PropertyRule.PropertyName) : nullptr;
+	return Accessor && Accessor->Match(Asset,PropertyRule);
+}
 
-	auto IsFloatLambda = [](UObject* Object,const FString& PropertyName)->bool
+FProperty* PropertyMatchOperator::FindSearchableProperty(const UClass* Class,const FString& PropertyName)
+{
+	FProperty* Property = IsValid(Class) ? Class->FindPropertyByName(FName(*PropertyName)) : nullptr;
+	return (Property && Property->HasAnyPropertyFlags(CPF_AssetRegistrySearchable)) ? Property : nullptr;
+}
+
+bool PropertyMatchOperator::NeedLoadAsset(const FScannerMatchRule& Rule) const
+{
+	for(const auto& MatchRule:Rule.PropertyMatchRules.MatchRules)
 	{
-		FProperty* Property = UFlibAssetParseHelper::GetPropertyByName(Object, PropertyName);
-		return Property->IsA(FFloatProperty::StaticClass());
-	};
-	auto IsFloatEqualLambda = [](const FString& L,const FString& R)->bool
+		for(const auto& PropertyRule:MatchRule.Rules)
+		{
+			if(!FindSearchableProperty(Rule.ScanAssetType,PropertyRule.PropertyName))
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool PropertyMatchOperator::GetRegistryTagFilter(const FScannerMatchRule& Rule,TMultiMap<FName,TOptional<FString>>& OutTagsAndValues)
+{
+	// FARFilter matches any of TagsAndValues, so only one predicate can be pushed down
+	if(Rule.PropertyMatchRules.bReverseCheck)
 	{
-		float LValue = UKismetStringLibrary::Conv_StringToFloat(L);
-		float RValue = UKismetStringLibrary::Conv_StringToFloat(R);
-		return (LValue == RValue);
-	};
-	
+		return false;
+	}
 	for(const auto& MatchRule:Rule.PropertyMatchRules.MatchRules)
 	{
-		int32 OptionalMatchNum = 0;
+		if(MatchRule.MatchLogic != EMatchLogic::Necessary)
+		{
+			continue;
+		}
 		for(const auto& PropertyRule:MatchRule.Rules)
 		{
-			bool bMatchResult = false;
-			FString Value = UFlibAssetParseHelper::GetPropertyValueByName(Asset,PropertyRule.PropertyName);
-			if(!Value.IsEmpty())
+			FProperty* Property = FindSearchableProperty(Rule.ScanAssetType,PropertyRule.PropertyName);
+			// numeric, bool, enum and object are compared by value, only text kinds are same as tag text
+			const bool bTextKind = Property && !Property->IsA(FNumericProperty::StaticClass()) && !Property->IsA(FBoolProperty::StaticClass()) &&
+				!Property->IsA(FEnumProperty::StaticClass()) && !Property->IsA(FObjectPropertyBase::StaticClass());
+			if(PropertyRule.MatchRule == EPropertyMatchRule::Equal && !PropertyRule.MatchValue.IsEmpty() && bTextKind)
 			{
-				bool bIsFloatType = IsFloatLambda(Asset,PropertyRule.PropertyName);
-				if(!bIsFloatType)
-				{
-					bMatchResult = Value.Equals(PropertyRule.MatchValue);
-				}
-				else
-				{
-					bMatchResult = IsFloatEqualLambda(Value,PropertyRule.MatchValue);
-				}
-				bMatchResult = (PropertyRule.MatchRule == EPropertyMatchRule::NotEqual) ? !bMatchResult : bMatchResult;
+				OutTagsAndValues.Add(Property->GetFName(),TOptional<FString>(PropertyRule.MatchValue));
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool CustomMatchOperator::Match(const FAssetData& AssetData,const FScannerMatchRule& Rule)
+{
+	FScannerAssetContext Context(AssetData);
+	return Match(Context,Rule);
+}
+
+bool CustomMatchOperator::Match(FScannerAssetContext& Context,const FScannerMatchRule& Rule)
+{
+	TArray<UOperatorBase*> Operators;
+	for(auto ExOperator:Rule.CustomRules)
+	{
+		if(IsValid(ExOperator))
+		{
+			UOperatorBase* Operator = Cast<UOperatorBase>(ExOperator->GetDefaultObject());
+			if(Operator)
+			{
+				Operators.Add(Operator);
 			}
-			if(bMatchResult)
+			else
 			{
-				OptionalMatchNum++;
+				UE_LOG(LogFlibAssetParseHelper,Log,TEXT("%s is Invalid UOperatorBase class!"),*ExOperator->GetName());
 			}
 		}
-		bool bIsMatchAllRules = (OptionalMatchNum == MatchRule.Rules.Num());
-		// Optional中匹配成功的数量必须与配置的一致
-		bIsMatched = (MatchRule.MatchLogic == EMatchLogic::Necessary) ? bIsMatchAllRules : (MatchRule.OptionalRuleMatchNum == OptionalMatchNum);
-		if(!bIsMatched)
+	}
+	return MatchOperators(Context,Operators);
+}
+
+bool CustomMatchOperator::Match(FScannerAssetContext& Context,const FScannerRuleProgram& Program)
+{
+	return MatchOperators(Context,Program.CustomOperators);
+}
+
+bool CustomMatchOperator::MatchOperators(FScannerAssetContext& Context,const TArray<UOperatorBase*>& Operators)
+{
+	const FAssetData& AssetData = Context.AssetData;
+	bool bIsMatched = true;
+	for(UOperatorBase* Operator:Operators)
+	{
+		FString AssetType = AssetData.AssetClass.ToString();
+		if(Operator->IsFastMatch())
+		{
+			// thread safe operator is native, skip ProcessEvent of BlueprintNativeEvent in worker threads
+			bIsMatched = Operator->IsThreadSafeFastMatch() ?
+				Operator->MatchFast_Implementation(AssetData.PackageName.ToString(),AssetType) :
+				Operator->MatchFast(AssetData.PackageName.ToString(),AssetType);
+		}
+		else
+		{
+			bIsMatched = Operator->Match(Context.GetAsset(),AssetType);
+		}
+		
+		if(!bIsMatched && Operator->GetMatchLogic() == EMatchLogic::Necessary)
 		{
 			break;
 		}
 	}
-	if(Rule.PropertyMatchRules.MatchRules.Num())
-	{
-		bIsMatched = Rule.PropertyMatchRules.bReverseCheck ? !bIsMatched : bIsMatched;
-	}
 	return bIsMatched;
 }
 
-bool CustomMatchOperator::Match(const FAssetData& AssetData,const FScannerMatchRule& Rule)
+bool CustomMatchOperator::IsThreadSafe(const FScannerMatchRule& Rule) const
 {
-	bool bIsMatched = true;
+	bool bThreadSafe = true;
 	for(auto ExOperator:Rule.CustomRules)
 	{
 		if(IsValid(ExOperator))
 		{
 			UOperatorBase* Operator = Cast<UOperatorBase>(ExOperator->GetDefaultObject());
-			if(Operator)
+			// blueprint operator must be call in GameThread
+			if(!Operator || !Operator->IsFastMatch() || !Operator->IsThreadSafeFastMatch() || !ExOperator->HasAnyClassFlags(CLASS_Native))
 			{
-				FString AssetType = AssetData.AssetClass.ToString();
-				if(Operator->IsFastMatch())
-				{
-					bIsMatched = Operator->MatchFast(AssetData.PackageName.ToString(),AssetType);
-				}
-				else
-				{
-					bIsMatched = Operator->Match(AssetData.GetAsset(),AssetType);
-				}
-				
-				if(!bIsMatched && Operator->GetMatchLogic() == EMatchLogic::Necessary)
-				{
-					break;
-				}
+				bThreadSafe = false;
+				break;
 			}
-			else
+		}
+	}
+	return bThreadSafe;
+}
+
+bool CustomMatchOperator::NeedLoadAsset(const FScannerMatchRule& Rule) const
+{
+	for(auto ExOperator:Rule.CustomRules)
+	{
+		if(IsValid(ExOperator))
+		{
+			UOperatorBase* Operator = Cast<UOperatorBase>(ExOperator->GetDefaultObject());
+			if(Operator && !Operator->IsFastMatch())
 			{
-				UE_LOG(LogFlibAssetParseHelper,Log,TEXT("% is Invalid UOperatorBase class!"),*ExOperator->GetName());
+				return true;
 			}
 		}
 	}
-	return bIsMatched;
+	return false;
 }
 
 bool CommiterMatchOperator::Match(const FAssetData& AssetData, const FScannerMatchRule& Rule)
 {
-	bool bIsAllow = true;
 	if(!Rule.CommiterMatchRules.bCheckCommiter)
 	{
 		return true;
 	}
-	
-	FString LongPackageName = AssetData.PackageName.ToString();
-
 	FString RepoRootDir = UFlibAssetParseHelper::ReplaceMarkPath(Rule.CommiterMatchRules.RepoDir);
-	if(FPaths::DirectoryExists(RepoRootDir) && FPackageName::DoesPackageExist(LongPackageName))
+	return MatchCommiter(AssetData,Rule.CommiterMatchRules,RepoRootDir,FPaths::DirectoryExists(RepoRootDir));
+}
+
+bool CommiterMatchOperator::Match(FScannerAssetContext& Context,const FScannerRuleProgram& Program)
+{
+	if(!Program.Rule->CommiterMatchRules.bCheckCommiter)
+	{
+		return true;
+	}
+	return MatchCommiter(Context.AssetData,Program.Rule->CommiterMatchRules,Program.CommiterRepoDir,Program.bCommiterRepoExists);
+}
+
+bool CommiterMatchOperator::MatchCommiter(const FAssetData& AssetData,const FCommiterMatchRule& CommiterRule,const FString& RepoRootDir,bool bRepoExists)
+{
+	bool bIsAllow = true;
+	FString LongPackageName = AssetData.PackageName.ToString();
+	if(bRepoExists && FPackageName::DoesPackageExist(LongPackageName))
 	{
 		bool bMachineNameIsAllow = false;
-		if(Rule.CommiterMatchRules.bUseHostName)
+		if(CommiterRule.bUseHostName)
 		{
 			FString HostName = UFlibOperationHelper::GetMachineHostName();
-			for(const auto& AllowCommiter:Rule.CommiterMatchRules.AllowCommiters)
+			for(const auto& AllowCommiter:CommiterRule.AllowCommiters)
 			{
 				if(HostName.StartsWith(AllowCommiter,ESearchCase::IgnoreCase))
 				{
@@ -720,7 +1108,7 @@ bool CommiterMatchOperator::Match(const FAssetData& AssetData, const FScannerMat
 		}
 		bool bGitIsAllow = false;
 
-		if(!bMachineNameIsAllow && Rule.CommiterMatchRules.bUseGitUserName)
+		if(!bMachineNameIsAllow && CommiterRule.bUseGitUserName)
 		{
 			FFileCommiter FileCommiter;
 			bool bGetStatus = UFlibAssetParseHelper::GetLocalEditorByLongPackageName(RepoRootDir,LongPackageName,FileCommiter);
@@ -730,9 +1118,9 @@ bool CommiterMatchOperator::Match(const FAssetData& AssetData, const FScannerMat
 				bGetStatus = UFlibAssetParseHelper::GetGitCommiterByLongPackageName(RepoRootDir,LongPackageName,FileCommiter);
 			}
 			
-			if(bGetStatus && Rule.CommiterMatchRules.bUseGitUserName && !FileCommiter.Commiter.IsEmpty())
+			if(bGetStatus && CommiterRule.bUseGitUserName && !FileCommiter.Commiter.IsEmpty())
 			{
-				bGitIsAllow = Rule.CommiterMatchRules.AllowCommiters.Contains(FileCommiter.Commiter);
+				bGitIsAllow = CommiterRule.AllowCommiters.Contains(FileCommiter.Commiter);
 			}
 		}
 		bIsAllow = bGitIsAllow || bMachineNameIsAllow;
@@ -2,6 +2,11 @@
 #include "ScanTimeRecorder.h"
 #include "FlibSourceControlHelper.h"
 #include "Misc/FileHelper.h"
+#include "Async/ParallelFor.h"
+#include "FScannerTextMatcher.h"
+#include "FScannerPackagePreloader.h"
+#include "FGitStatusSnapshot.h"
+#include "FGitLastCommitIndex.h"
 
 DEFINE_LOG_CATEGORY(LogResScannerProxy);
 #define LOCTEXT_NAMESPACE "UResScannerProxy"
@@ -24,86 +29,518 @@ void UResScannerProxy::Shutdown()
 {
 }
 
-FRuleMatchedInfo UResScannerProxy::ScanSingleRule(const TArray<FAssetData>& GlobalAssets,const FScannerMatchRule& ScannerRule,int32 RuleID/* = 0*/)
+TSharedPtr<const FScannerRuleProgram> UResScannerProxy::CompileRule(const FScannerMatchRule& ScannerRule,int32 RuleID,const TSharedPtr<FScannerTextMatcher>& TextMatcher)
 {
-	FScanTimeRecorder RuleTimeRecorder(ScannerRule.RuleName);
-	
-	FScopedNamedEventStatic ScanSingleRule(FColor::Red,*ScannerRule.RuleName);
-	FRuleMatchedInfo RuleMatchedInfo;
-	// FScannerMatchRule& ScannerRule = GetScannerConfig()->ScannerRules[RuleID];
 	if(!ScannerRule.bEnableRule)
 	{
 		UE_LOG(LogResScannerProxy,Warning,TEXT("rule %s is missed!"),*ScannerRule.RuleName);
-		return RuleMatchedInfo;
+		return nullptr;
 	}
 	if(!ScannerRule.ScanFilters.Num() && !ScannerConfig->bByGlobalScanFilters)
 	{
 		UE_LOG(LogResScannerProxy,Warning,TEXT("rule %s not contain any filters!"),*ScannerRule.RuleName);
-		return RuleMatchedInfo;
+		return nullptr;
 	}
 	if(!ScannerRule.HasValidRules())
 	{
 		UE_LOG(LogResScannerProxy,Warning,TEXT("rule %s not contain any rules!"),*ScannerRule.RuleName);
-		return RuleMatchedInfo;
+		return nullptr;
 	}
-	
-	FString RuleConfig;
-	TemplateHelper::TSerializeStructAsJsonString(ScannerRule,RuleConfig);
+	return FScannerRuleProgram::Compile(ScannerRule,RuleID,*GetScannerConfig(),GetMatchOperators(),TextMatcher);
+}
 
+FString UResScannerProxy::GetCandidateSignature(const FScannerMatchRule& ScannerRule,TMultiMap<FName,TOptional<FString>>& OutTagsAndValues)
+{
+	const bool bGlobalAssets = GetScannerConfig()->bByGlobalScanFilters || GetScannerConfig()->GitChecker.bGitCheck;
+	const bool bRegistryAssets = !GetScannerConfig()->bBlockRuleFilter;
+	// push down property rule to asset registry query
+	if(bRegistryAssets && GetMatchOperators().Contains(TEXT("PropertyMatchRule")))
+	{
+		PropertyMatchOperator::GetRegistryTagFilter(ScannerRule,OutTagsAndValues);
+	}
+	return FScannerCandidatePlanner::GetSignature(ScannerRule,bGlobalAssets,bRegistryAssets,OutTagsAndValues);
+}
+
+void UResScannerProxy::PrepareRuleTask(const TArray<FAssetData>& GlobalAssets,const FScannerClassIndex& GlobalClassIndex,const TSharedPtr<const FScannerRuleProgram>& Program,FScannerRuleTask& OutRuleTask)
+{
+	const FScannerMatchRule& ScannerRule = *Program->Rule;
 	if(GetScannerConfig()->bVerboseLog)
 	{
+		FString RuleConfig;
+		TemplateHelper::TSerializeStructAsJsonString(ScannerRule,RuleConfig);
 		UE_LOG(LogResScannerProxy,Display,TEXT("RuleName %s is Scanning."),*ScannerRule.RuleName);
 		UE_LOG(LogResScannerProxy,Display,TEXT("RuleName %s is Scanning. config:\n%s"),*ScannerRule.RuleName,*RuleConfig);
 	}
 	
-	TArray<FAssetData> FilterAssets;
-	if(GetScannerConfig()->bByGlobalScanFilters || GetScannerConfig()->GitChecker.bGitCheck)
+	OutRuleTask.Program = Program;
+	TMultiMap<FName,TOptional<FString>> TagsAndValues;
+	const FString Signature = GetCandidateSignature(ScannerRule,TagsAndValues);
+	OutRuleTask.CandidateAssets = CandidatePlanner.Acquire(Signature,[this,&GlobalAssets,&GlobalClassIndex,&ScannerRule,&TagsAndValues]()->TArray<FAssetData>
+	{
+		TArray<FAssetData> Assets;
+		if(GetScannerConfig()->bByGlobalScanFilters || GetScannerConfig()->GitChecker.bGitCheck)
+		{
+			TArray<FString> ScanTypes;
+			if(IsValid(ScannerRule.ScanAssetType))
+			{
+				ScanTypes.Add(ScannerRule.ScanAssetType->GetName());
+			}
+			Assets = UFlibAssetParseHelper::GetAssetsWithCachedByTypes(GlobalAssets,GlobalClassIndex,ScanTypes,ScannerRule.bGlobalAssetMustMatchFilter,ScannerRule.ScanFilters,ScannerRule.RecursiveClasses);
+		}
+		if(!GetScannerConfig()->bBlockRuleFilter)
+		{
+			Assets.Append(UFlibAssetParseHelper::GetAssetsByFiltersByClass(TArray<UClass*>{ScannerRule.ScanAssetType},ScannerRule.ScanFilters,ScannerRule.RecursiveClasses,TagsAndValues));
+		}
+		if(ShardNum > 1)
+		{
+			Assets.RemoveAll([this](const FAssetData& Asset){ return !IsInShard(Asset.PackageName); });
+		}
+		return Assets;
+	});
+	OutRuleTask.AssetSnapshot = &AssetSnapshot;
+	AssetSnapshot.Add(OutRuleTask.GetAssets(),OutRuleTask.SnapshotIndices);
+	OutRuleTask.MatchedFlags.SetNumZeroed(OutRuleTask.GetAssets().Num());
+	OutRuleTask.AssetStates.Init(EScannerAssetState::Ignored,OutRuleTask.GetAssets().Num());
+	if(ScanCache.IsValid())
+	{
+		OutRuleTask.CacheKey = FScannerScanCache::GetRuleFingerprint(ScannerRule);
+		if(!OutRuleTask.CacheKey.IsEmpty())
+		{
+			ScanCache->PreparePackages(OutRuleTask.GetAssets());
+			ScanCache->FetchSharedResults(OutRuleTask.CacheKey,ScannerRule.RuleName,OutRuleTask.GetAssets());
+		}
+	}
+}
+
+void UResScannerProxy::MatchThreadSafeLane(FScannerRuleTask& RuleTask,int32 AssetIndex,bool bHasOperators,const FScannerScanCache* InScanCache,FScannerOperatorSelectivity* Selectivity)
+{
+	const FScannerRuleProgram& Program = *RuleTask.Program;
+	const FAssetData& Asset = RuleTask.GetAssets()[AssetIndex];
+	bool bMatched = false;
+	EScannerAssetState AssetState = EScannerAssetState::Ignored;
+	if(bHasOperators && !Program.IgnoreIndex.IsIgnored(Asset))
+	{
+		if(InScanCache && !RuleTask.CacheKey.IsEmpty() && InScanCache->FindResult(RuleTask.CacheKey,Asset,bMatched))
+		{
+			AssetState = EScannerAssetState::Cached;
+		}
+		else
+		{
+			FScannerAssetContext Context = RuleTask.MakeContext(AssetIndex);
+			AssetState = EScannerAssetState::Evaluated;
+			bMatched = MatchAllOperators(Context,Program,Program.ParallelOperators,Selectivity);
+		}
+	}
+	RuleTask.MatchedFlags[AssetIndex] = bMatched ? 1 : 0;
+	RuleTask.AssetStates[AssetIndex] = AssetState;
+}
+
+void UResScannerProxy::RecordScanCache(const FScannerRuleTask& RuleTask)
+{
+	if(!ScanCache.IsValid() || RuleTask.CacheKey.IsEmpty())
+	{
+		return;
+	}
+	for(int32 AssetIndex = 0;AssetIndex < RuleTask.GetAssets().Num();++AssetIndex)
+	{
+		if(RuleTask.AssetStates[AssetIndex] == EScannerAssetState::Evaluated)
+		{
+			ScanCache->AddResult(RuleTask.CacheKey,RuleTask.Program->Rule->RuleName,RuleTask.GetAssets()[AssetIndex],!!RuleTask.MatchedFlags[AssetIndex]);
+		}
+	}
+}
+
+bool UResScannerProxy::MatchAllOperators(FScannerAssetContext& Context,const FScannerRuleProgram& Program,const TArray<TSharedPtr<IMatchOperator>>& Operators,FScannerOperatorSelectivity* Selectivity)
+{
+	bool bMatchAllRules = true;
+	if(!Selectivity)
+	{
+		for(const auto& Operator:Operators)
+		{
+			bMatchAllRules = Operator->Match(Context,Program);
+			if(!bMatchAllRules)
+			{
+				break;
+			}
+		}
+		return bMatchAllRules;
+	}
+	for(int32 OperatorIndex:Selectivity->GetOrder())
 	{
-		FilterAssets = UFlibAssetParseHelper::GetAssetsWithCachedByTypes(GlobalAssets,TArray<UClass*>{ScannerRule.ScanAssetType},ScannerRule.bGlobalAssetMustMatchFilter,ScannerRule.ScanFilters,ScannerRule.RecursiveClasses);
+		bMatchAllRules = Operators[OperatorIndex]->Match(Context,Program);
+		Selectivity->Record(OperatorIndex,bMatchAllRules);
+		if(!bMatchAllRules)
+		{
+			break;
+		}
 	}
-	if(!GetScannerConfig()->bBlockRuleFilter)
+	Selectivity->FinishAsset();
+	return bMatchAllRules;
+}
+
+void UResScannerProxy::FinishRuleTask(const FScannerRuleTask& RuleTask,FRuleMatchedInfo& RuleMatchedInfo)
+{
+	if(GetScannerConfig()->bVerboseLog)
+	{
+		for(const auto& Asset:RuleMatchedInfo.Assets)
+		{
+			UE_LOG(LogResScannerProxy,Display,TEXT("\t%s"),*Asset.GetFullName());
+		}
+	}
+	const FScannerMatchRule& Rule = *RuleTask.Program->Rule;
+	if(!!RuleMatchedInfo.Assets.Num() && Rule.bEnablePostProcessor)
+	{
+		// 对扫描之后的资源进行后处理（可以执行自动化处理操作）
+		PostProcessorMatchRule(Rule,RuleMatchedInfo);
+	}
+}
+
+FRuleMatchedInfo UResScannerProxy::ScanSingleRule(const TArray<FAssetData>& GlobalAssets,const FScannerMatchRule& ScannerRule,int32 RuleID/* = 0*/)
+{
+	TSharedPtr<FScannerTextMatcher> TextMatcher = MakeShareable(new FScannerTextMatcher);
+	TSharedPtr<const FScannerRuleProgram> Program = CompileRule(ScannerRule,RuleID,TextMatcher);
+	if(!Program.IsValid())
 	{
-		FilterAssets.Append(UFlibAssetParseHelper::GetAssetsByFiltersByClass(TArray<UClass*>{ScannerRule.ScanAssetType},ScannerRule.ScanFilters,ScannerRule.RecursiveClasses));
+		return FRuleMatchedInfo{};
 	}
+	TextMatcher->Build();
+	FScannerClassIndex GlobalClassIndex;
+	GlobalClassIndex.Build(GlobalAssets);
+	FRuleMatchedInfo RuleMatchedInfo = ScanSingleRule(GlobalAssets,GlobalClassIndex,Program);
+	AssetSnapshot.Reset();
+	return RuleMatchedInfo;
+}
+
+FRuleMatchedInfo UResScannerProxy::ScanSingleRule(const TArray<FAssetData>& GlobalAssets,const FScannerClassIndex& GlobalClassIndex,const TSharedPtr<const FScannerRuleProgram>& Program)
+{
+	const FScannerMatchRule& ScannerRule = *Program->Rule;
+	FScanTimeRecorder RuleTimeRecorder(ScannerRule.RuleName);
+	
+	FScopedNamedEventStatic ScanSingleRule(FColor::Red,*ScannerRule.RuleName);
+	FRuleMatchedInfo RuleMatchedInfo;
+	FScannerRuleTask RuleTask;
+	PrepareRuleTask(GlobalAssets,GlobalClassIndex,Program,RuleTask);
+	AssetSnapshot.Build(Program->TextMatcher.Get());
 	RuleMatchedInfo.RuleName = ScannerRule.RuleName;
 	RuleMatchedInfo.RuleDescribe = ScannerRule.RuleDescribe;
-	RuleMatchedInfo.RuleID  = RuleID;
-	TArray<FAssetFilters> FinalIgnoreFilters;
-	FinalIgnoreFilters.Add(GetScannerConfig()->GlobalIgnoreFilters);
+	RuleMatchedInfo.RuleID  = Program->RuleID;
 	
-	FinalIgnoreFilters.Add(ScannerRule.IgnoreFilters);
-	
-	for(const auto& Asset:FilterAssets)
+	const bool bHasOperators = !!GetMatchOperators().Num();
+	FScannerOperatorSelectivity Selectivity;
+	Selectivity.Init(Program->ParallelOperators,ScannerRule);
+	for(int32 AssetIndex = 0;AssetIndex < RuleTask.GetAssets().Num();++AssetIndex)
+	{
+		MatchThreadSafeLane(RuleTask,AssetIndex,bHasOperators,ScanCache.Get(),&Selectivity);
+	}
+	// all candidates of GameThread lane are known, so the packages can be preloaded
+	MatchGameThreadLane(RuleTask);
+	for(int32 AssetIndex = 0;AssetIndex < RuleTask.GetAssets().Num();++AssetIndex)
 	{
-		if(!UFlibAssetParseHelper::IsIgnoreAsset(Asset,FinalIgnoreFilters))
+		if(RuleTask.MatchedFlags[AssetIndex])
 		{
-			bool bMatchAllRules = !!GetMatchOperators().Num() ? true : false;
-			for(const auto& Operator:GetMatchOperators())
-			{
-				bMatchAllRules = Operator.Value->Match(Asset,ScannerRule);
-				if(!bMatchAllRules)
-				{
-					break;
-				}
-			}
-			if(bMatchAllRules)
+			const FAssetData& Asset = RuleTask.GetAssets()[AssetIndex];
+			RuleMatchedInfo.Assets.AddUnique(Asset);
+			RuleMatchedInfo.AssetPackageNames.AddUnique(RuleTask.AssetSnapshot->PackageNames[RuleTask.SnapshotIndices[AssetIndex]]);
+		}
+	}
+	RecordScanCache(RuleTask);
+	FinishRuleTask(RuleTask,RuleMatchedInfo);
+	return RuleMatchedInfo;
+}
+
+void UResScannerProxy::ScanRulesByTask(const TArray<FAssetData>& GlobalAssets,const FScannerClassIndex& GlobalClassIndex,const TArray<TSharedPtr<const FScannerRuleProgram>>& Programs,FMatchedResult& OutResult)
+{
+	SCOPED_NAMED_EVENT_TEXT("UResScannerProxy::ScanRulesByTask",FColor::Red);
+	FScanTimeRecorder TaskTimeRecorder(FString::Printf(TEXT("ScanRulesByTask %d rules."),Programs.Num()));
+
+	// asset registry query must be in GameThread
+	TArray<FScannerRuleTask> RuleTasks;
+	RuleTasks.SetNum(Programs.Num());
+	for(int32 Index = 0;Index < Programs.Num();++Index)
+	{
+		PrepareRuleTask(GlobalAssets,GlobalClassIndex,Programs[Index],RuleTasks[Index]);
+	}
+	// all rules in ScanAssets share one text matcher
+	AssetSnapshot.Build(Programs.Num() ? Programs[0]->TextMatcher.Get() : nullptr);
+
+	struct FRuleChunk
+	{
+		int32 TaskIndex;
+		int32 Begin;
+		int32 End;
+	};
+	TArray<FRuleChunk> Chunks;
+	const int32 BatchSize = FMath::Max(1,GetScannerConfig()->ParallelBatchSize);
+	for(int32 TaskIndex = 0;TaskIndex < RuleTasks.Num();++TaskIndex)
+	{
+		const FScannerRuleTask& RuleTask = RuleTasks[TaskIndex];
+		for(int32 Begin = 0;Begin < RuleTask.GetAssets().Num();Begin += BatchSize)
+		{
+			Chunks.Add(FRuleChunk{TaskIndex,Begin,FMath::Min(Begin + BatchSize,RuleTask.GetAssets().Num())});
+		}
+	}
+
+	// ignore filters & thread safe operators, every chunk only write self range of MatchedFlags
+	const bool bHasOperators = !!GetMatchOperators().Num();
+	const FScannerScanCache* InScanCache = ScanCache.Get();
+	auto MatchChunk = [&RuleTasks,&Chunks,bHasOperators,InScanCache](int32 ChunkIndex)
+	{
+		const FRuleChunk& Chunk = Chunks[ChunkIndex];
+		FScannerRuleTask& RuleTask = RuleTasks[Chunk.TaskIndex];
+		FScannerOperatorSelectivity Selectivity;
+		Selectivity.Init(RuleTask.Program->ParallelOperators,*RuleTask.Program->Rule);
+		for(int32 AssetIndex = Chunk.Begin;AssetIndex < Chunk.End;++AssetIndex)
+		{
+			MatchThreadSafeLane(RuleTask,AssetIndex,bHasOperators,InScanCache,&Selectivity);
+		}
+	};
+	if(GetScannerConfig()->bParallelScan)
+	{
+		UE_LOG(LogResScannerProxy,Display,TEXT("Parallel Scan %d rules by %d tasks."),Programs.Num(),Chunks.Num());
+		ParallelFor(Chunks.Num(),MatchChunk);
+	}
+	else
+	{
+		for(int32 ChunkIndex = 0;ChunkIndex < Chunks.Num();++ChunkIndex)
+		{
+			MatchChunk(ChunkIndex);
+		}
+	}
+
+	// GameThread lane: operators need load asset
+	if(GetScannerConfig()->bAssetMajorScan)
+	{
+		// every rule is finished after the single pass
+		MatchGameThreadByAsset(RuleTasks);
+		for(auto& RuleTask:RuleTasks)
+		{
+			EmitRuleTask(RuleTask,OutResult);
+		}
+	}
+	else
+	{
+		MatchGameThreadByRule(RuleTasks,OutResult);
+	}
+}
+
+void UResScannerProxy::EmitRuleTask(FScannerRuleTask& RuleTask,FMatchedResult& OutResult)
+{
+	RecordScanCache(RuleTask);
+	FRuleMatchedInfo RuleMatchedInfo;
+	RuleMatchedInfo.RuleName = RuleTask.Program->Rule->RuleName;
+	RuleMatchedInfo.RuleDescribe = RuleTask.Program->Rule->RuleDescribe;
+	RuleMatchedInfo.RuleID = RuleTask.Program->RuleID;
+	for(int32 AssetIndex = 0;AssetIndex < RuleTask.GetAssets().Num();++AssetIndex)
+	{
+		if(RuleTask.MatchedFlags[AssetIndex])
+		{
+			const FAssetData& Asset = RuleTask.GetAssets()[AssetIndex];
+			RuleMatchedInfo.Assets.AddUnique(Asset);
+			RuleMatchedInfo.AssetPackageNames.AddUnique(RuleTask.AssetSnapshot->PackageNames[RuleTask.SnapshotIndices[AssetIndex]]);
+		}
+	}
+	FinishRuleTask(RuleTask,RuleMatchedInfo);
+	EmitRuleResult(RuleMatchedInfo,OutResult);
+	RuleTask.CandidateAssets.Reset();
+	RuleTask.MatchedFlags.Empty();
+	RuleTask.AssetStates.Empty();
+}
+
+void UResScannerProxy::EmitRuleResult(FRuleMatchedInfo& RuleMatchedInfo,FMatchedResult& OutResult)
+{
+	// shard results keep all rules, the order of rules is kept when merging shards
+	if(!RuleMatchedInfo.Assets.Num() && ShardNum <= 1)
+	{
+		return;
+	}
+	const bool bStreamResult = GetScannerConfig()->bStreamResult && !!ResultSinks.Num();
+	const bool bRecordCommiter = GetScannerConfig()->GitChecker.bGitCheck && GetScannerConfig()->GitChecker.bRecordCommiter;
+	if(bRecordCommiter && ResultSinks.Num())
+	{
+		// sinks receive the rule with commiters, SaveScanResult skips rules already recorded
+		FMatchedResult RuleResult;
+		RuleResult.GetMatchedInfo().Add(MoveTemp(RuleMatchedInfo));
+		UFlibAssetParseHelper::CheckMatchedAssetsCommiter(RuleResult,GetScannerConfig()->GitChecker.GetRepoDir());
+		RuleMatchedInfo = MoveTemp(RuleResult.GetMatchedInfo()[0]);
+	}
+	for(const auto& ResultSink:ResultSinks)
+	{
+		ResultSink->OnRuleMatched(RuleMatchedInfo);
+	}
+	if(bStreamResult)
+	{
+		RuleMatchedInfo.Assets.Empty();
+		RuleMatchedInfo.AssetPackageNames.Empty();
+		RuleMatchedInfo.AssetsCommiter.Empty();
+	}
+	OutResult.GetMatchedInfo().Add(MoveTemp(RuleMatchedInfo));
+}
+
+void UResScannerProxy::MatchGameThreadByRule(TArray<FScannerRuleTask>& RuleTasks,FMatchedResult& OutResult)
+{
+	for(auto& RuleTask:RuleTasks)
+	{
+		MatchGameThreadLane(RuleTask);
+		EmitRuleTask(RuleTask,OutResult);
+	}
+}
+
+void UResScannerProxy::MatchGameThreadLane(FScannerRuleTask& RuleTask)
+{
+	const FScannerRuleProgram& Program = *RuleTask.Program;
+	if(!Program.GameThreadOperators.Num())
+	{
+		return;
+	}
+	FScopedNamedEventStatic ScanSingleRule(FColor::Red,*Program.Rule->RuleName);
+	TArray<int32> LaneAssets;
+	for(int32 AssetIndex = 0;AssetIndex < RuleTask.GetAssets().Num();++AssetIndex)
+	{
+		if(RuleTask.MatchedFlags[AssetIndex] && RuleTask.AssetStates[AssetIndex] == EScannerAssetState::Evaluated)
+		{
+			LaneAssets.Add(AssetIndex);
+		}
+	}
+	TUniquePtr<FScannerPackagePreloader> Preloader;
+	if(Program.bNeedLoadAsset && GetScannerConfig()->PreloadPackageNum > 0)
+	{
+		TArray<FName> PackageNames;
+		PackageNames.Reserve(LaneAssets.Num());
+		for(int32 AssetIndex:LaneAssets)
+		{
+			PackageNames.Add(RuleTask.GetAssets()[AssetIndex].PackageName);
+		}
+		Preloader = MakeUnique<FScannerPackagePreloader>(PackageNames,GetScannerConfig()->PreloadPackageNum);
+	}
+	FScannerOperatorSelectivity Selectivity;
+	Selectivity.Init(Program.GameThreadOperators,*Program.Rule);
+	for(int32 LaneIndex = 0;LaneIndex < LaneAssets.Num();++LaneIndex)
+	{
+		const int32 AssetIndex = LaneAssets[LaneIndex];
+		if(Preloader.IsValid())
+		{
+			Preloader->Prepare(LaneIndex);
+		}
+		FScannerAssetContext Context = RuleTask.MakeContext(AssetIndex);
+		RuleTask.MatchedFlags[AssetIndex] = MatchAllOperators(Context,Program,Program.GameThreadOperators,&Selectivity) ? 1 : 0;
+		if(Preloader.IsValid())
+		{
+			Preloader->Finish(LaneIndex);
+		}
+		if(Context.IsLoaded())
+		{
+			Context.Release();
+			CheckMemoryBudget(Preloader.Get());
+		}
+	}
+}
+
+void UResScannerProxy::CheckMemoryBudget(FScannerPackagePreloader* Preloader)
+{
+	// memory of editor before scanning is not counted
+	const uint64 UsedMemory = PackageTracker.GetUsedMemory();
+	PeakUsedMemory = FMath::Max<uint64>(PeakUsedMemory,UsedMemory);
+	const uint64 MemoryBudget = (uint64)FMath::Max(0,GetScannerConfig()->MemoryBudgetMB) * 1024 * 1024;
+	if(!MemoryBudget || UsedMemory <= MemoryBudget)
+	{
+		return;
+	}
+	SCOPED_NAMED_EVENT_TEXT("UResScannerProxy::CheckMemoryBudget",FColor::Red);
+	// preloaded packages not matched yet are referenced and kept by GC
+	if(Preloader)
+	{
+		Preloader->ReleaseFinished();
+	}
+	const int32 UnloadNum = PackageTracker.UnloadPackages();
+	++BudgetGCNum;
+	UE_LOG(LogResScannerProxy,Display,TEXT("Scan used memory %llu MB is over budget %d MB, unload %d packages to %llu MB."),
+		UsedMemory / 1024 / 1024,GetScannerConfig()->MemoryBudgetMB,UnloadNum,PackageTracker.GetUsedMemory() / 1024 / 1024);
+}
+
+void UResScannerProxy::MatchGameThreadByAsset(TArray<FScannerRuleTask>& RuleTasks)
+{
+	SCOPED_NAMED_EVENT_TEXT("UResScannerProxy::MatchGameThreadByAsset",FColor::Red);
+	// union of all rules candidate, value is TaskIndex and AssetIndex of the task
+	TArray<int32> UnionAssetIndexMap;
+	UnionAssetIndexMap.Init(INDEX_NONE,AssetSnapshot.Num());
+	TArray<const FAssetData*> UnionAssets;
+	TArray<int32> UnionSnapshotIndices;
+	TArray<TArray<TPair<int32,int32>>> UnionAssetRefs;
+	bool bNeedLoadAsset = false;
+	for(int32 TaskIndex = 0;TaskIndex < RuleTasks.Num();++TaskIndex)
+	{
+		const FScannerRuleTask& RuleTask = RuleTasks[TaskIndex];
+		if(!RuleTask.Program->GameThreadOperators.Num())
+		{
+			continue;
+		}
+		for(int32 AssetIndex = 0;AssetIndex < RuleTask.GetAssets().Num();++AssetIndex)
+		{
+			if(!RuleTask.MatchedFlags[AssetIndex] || RuleTask.AssetStates[AssetIndex] != EScannerAssetState::Evaluated)
 			{
-				RuleMatchedInfo.Assets.AddUnique(Asset);
-				RuleMatchedInfo.AssetPackageNames.AddUnique(Asset.PackageName.ToString());
+				continue;
 			}
-			if(GetScannerConfig()->bVerboseLog && bMatchAllRules)
+			const int32 SnapshotIndex = RuleTask.SnapshotIndices[AssetIndex];
+			int32& UnionIndex = UnionAssetIndexMap[SnapshotIndex];
+			if(UnionIndex == INDEX_NONE)
 			{
-				UE_LOG(LogResScannerProxy,Display,TEXT("\t%s"),*Asset.GetFullName());
+				UnionIndex = UnionAssets.Num();
+				UnionAssets.Add(&RuleTask.GetAssets()[AssetIndex]);
+				UnionSnapshotIndices.Add(SnapshotIndex);
+				UnionAssetRefs.AddDefaulted();
 			}
+			UnionAssetRefs[UnionIndex].Emplace(TaskIndex,AssetIndex);
 		}
+		bNeedLoadAsset |= RuleTask.Program->bNeedLoadAsset;
 	}
-	
-	if(!!RuleMatchedInfo.Assets.Num() && ScannerRule.bEnablePostProcessor)
+	UE_LOG(LogResScannerProxy,Display,TEXT("Asset-major Scan %d assets."),UnionAssets.Num());
+
+	TUniquePtr<FScannerPackagePreloader> Preloader;
+	if(bNeedLoadAsset && GetScannerConfig()->PreloadPackageNum > 0)
 	{
-		// 对扫描之后的资源进行后处理（可以执行自动化处理操作）
-		PostProcessorMatchRule(ScannerRule,RuleMatchedInfo);
+		TArray<FName> PackageNames;
+		PackageNames.Reserve(UnionAssets.Num());
+		for(const FAssetData* Asset:UnionAssets)
+		{
+			PackageNames.Add(Asset->PackageName);
+		}
+		Preloader = MakeUnique<FScannerPackagePreloader>(PackageNames,GetScannerConfig()->PreloadPackageNum);
+	}
+	TArray<FScannerOperatorSelectivity> Selectivities;
+	Selectivities.SetNum(RuleTasks.Num());
+	for(int32 TaskIndex = 0;TaskIndex < RuleTasks.Num();++TaskIndex)
+	{
+		Selectivities[TaskIndex].Init(RuleTasks[TaskIndex].Program->GameThreadOperators,*RuleTasks[TaskIndex].Program->Rule);
+	}
+	const int32 GCInterval = GetScannerConfig()->AssetMajorGCInterval;
+	int32 LoadedNum = 0;
+	for(int32 UnionIndex = 0;UnionIndex < UnionAssets.Num();++UnionIndex)
+	{
+		if(Preloader.IsValid())
+		{
+			Preloader->Prepare(UnionIndex);
+		}
+		FScannerAssetContext Context(*UnionAssets[UnionIndex],&AssetSnapshot,UnionSnapshotIndices[UnionIndex]);
+		for(const auto& AssetRef:UnionAssetRefs[UnionIndex])
+		{
+			FScannerRuleTask& RuleTask = RuleTasks[AssetRef.Key];
+			RuleTask.MatchedFlags[AssetRef.Value] = MatchAllOperators(Context,*RuleTask.Program,RuleTask.Program->GameThreadOperators,&Selectivities[AssetRef.Key]) ? 1 : 0;
+		}
+		if(Preloader.IsValid())
+		{
+			Preloader->Finish(UnionIndex);
+		}
+		if(Context.IsLoaded())
+		{
+			Context.Release();
+			++LoadedNum;
+			if(GCInterval > 0 && LoadedNum % GCInterval == 0)
+			{
+				PackageTracker.UnloadPackages();
+			}
+			CheckMemoryBudget(Preloader.Get());
+		}
 	}
-	return RuleMatchedInfo;
 }
 
 FMatchedResult UResScannerProxy::DoScan()
@@ -113,6 +550,40 @@ FMatchedResult UResScannerProxy::DoScan()
 	TemplateHelper::TSerializeStructAsJsonString(*GetScannerConfig(),ScanConfigContent);
 	UE_LOG(LogResScannerProxy, Display, TEXT("%s"), *ScanConfigContent);
 
+	TArray<FAssetData> GlobalAssets = GetGlobalAssets();
+
+	bool bRecordCommiter = GetScannerConfig()->GitChecker.bGitCheck && GetScannerConfig()->GitChecker.bRecordCommiter;
+	FString SaveBasePath = UFlibAssetParseHelper::ReplaceMarkPath(GetScannerConfig()->SavePath.Path);
+	FString Name = GetResultName();
+
+	// write result file while scanning
+	TSharedPtr<FScannerFileResultSink> StreamResultSink;
+	if(GetScannerConfig()->bSaveResult && GetScannerConfig()->bStreamResult)
+	{
+		if(GetScannerConfig()->bSavaeLiteResult)
+		{
+			StreamResultSink = MakeShareable(new FScannerLiteResultSink(FPaths::Combine(SaveBasePath,FString::Printf(TEXT("%s_result.txt"),*Name)),bRecordCommiter));
+		}
+		else
+		{
+			StreamResultSink = MakeShareable(new FScannerNDJsonResultSink(FPaths::Combine(SaveBasePath,FString::Printf(TEXT("%s_result.ndjson"),*Name)),bRecordCommiter));
+		}
+		AddResultSink(StreamResultSink);
+	}
+	
+	FMatchedResult MatchedResult = ScanAssets(GlobalAssets);
+	
+	if(StreamResultSink.IsValid())
+	{
+		RemoveResultSink(StreamResultSink);
+	}
+	SaveScanResult(MatchedResult,Name,StreamResultSink.IsValid() ? StreamResultSink->GetSaveFile() : FString());
+	return MatchedResult;
+}
+
+TArray<FAssetData> UResScannerProxy::GetGlobalAssets()
+{
+	SCOPED_NAMED_EVENT_TEXT("UResScannerProxy::GetGlobalAssets",FColor::Red);
 	TArray<FAssetData> GlobalAssets;
 	if(GetScannerConfig()->bByGlobalScanFilters)
 	{
@@ -143,20 +614,33 @@ FMatchedResult UResScannerProxy::DoScan()
 			UE_LOG(LogResScannerProxy,Display,TEXT("%s is not a valid git repo."),*OutRepoDir);
 		}
 	}
+	return GlobalAssets;
+}
 
-	FMatchedResult MatchedResult = ScanAssets(GlobalAssets);
-	
-	bool bRecordCommiter = GetScannerConfig()->GitChecker.bGitCheck && GetScannerConfig()->GitChecker.bRecordCommiter;
-	MatchedResult.RecordGitCommiter(bRecordCommiter,GetScannerConfig()->GitChecker.GetRepoDir());
-	
-	FString SaveBasePath = UFlibAssetParseHelper::ReplaceMarkPath(GetScannerConfig()->SavePath.Path);
-
-
+FString UResScannerProxy::GetResultName()
+{
 	FString Name = GetScannerConfig()->ConfigName;
 	if(Name.IsEmpty())
 	{
 		Name = FDateTime::UtcNow().ToString();
 	}
+	return Name;
+}
+
+void UResScannerProxy::SaveScanResult(FMatchedResult& MatchedResult,const FString& Name,const FString& StreamedFile)
+{
+	bool bRecordCommiter = GetScannerConfig()->GitChecker.bGitCheck && GetScannerConfig()->GitChecker.bRecordCommiter;
+	FString SaveBasePath = UFlibAssetParseHelper::ReplaceMarkPath(GetScannerConfig()->SavePath.Path);
+	if(!StreamedFile.IsEmpty())
+	{
+		// commiter is recorded in streaming
+		MatchedResult.RecordGitCommiter(false,GetScannerConfig()->GitChecker.GetRepoDir());
+	}
+	else
+	{
+		MatchedResult.RecordGitCommiter(bRecordCommiter,GetScannerConfig()->GitChecker.GetRepoDir());
+	}
+	FGitLastCommitIndex::ResetAll();
 	
 	// serialize config
 	if(GetScannerConfig()->bSaveConfig)
@@ -175,8 +659,17 @@ FMatchedResult UResScannerProxy::DoScan()
 	FString ResultSavePath = FPaths::Combine(SaveBasePath,FString::Printf(TEXT("%s_result.json"),*Name));
 	IFileManager::Get().Delete(*ResultSavePath);
 	
+	// streamed assets are not in MatchedResult, the streamed file is the result
+	if(!StreamedFile.IsEmpty())
+	{
+		if(MatchedResult.HasValidResult() && !IsRunningCommandlet())
+		{
+			FText Msg = LOCTEXT("SavedScanResultMag", "Successd to Export the scan result.");
+			UFlibAssetParseHelper::CreateSaveFileNotify(Msg,StreamedFile,SNotificationItem::CS_Success);
+		}
+	}
 	// serialize matched assets
-	if(GetScannerConfig()->bSaveResult && MatchedResult.HasValidResult())
+	else if(GetScannerConfig()->bSaveResult && MatchedResult.HasValidResult())
 	{
 		FString SerializedJsonStr = MatchedResult.SerializeResult(GetScannerConfig()->bSavaeLiteResult);
 		
@@ -193,7 +686,18 @@ FMatchedResult UResScannerProxy::DoScan()
 			}
 		}
 	}
-	return MatchedResult;
+}
+
+void UResScannerProxy::SetShard(int32 InShardIndex,int32 InShardNum)
+{
+	ShardNum = FMath::Max(InShardNum,1);
+	ShardIndex = FMath::Clamp(InShardIndex,0,ShardNum - 1);
+}
+
+bool UResScannerProxy::IsInShard(FName PackageName)const
+{
+	// FName hash is different in every process, shard by the crc of package name
+	return ShardNum <= 1 || FCrc::StrCrc32(*PackageName.ToString()) % (uint32)ShardNum == (uint32)ShardIndex;
 }
 
 void UResScannerProxy::SetScannerConfig(FScannerConfig InConfig)
@@ -209,47 +713,113 @@ FMatchedResult UResScannerProxy::ScanAssets(const TArray<FAssetData>& Assets)
 {
 	FScanTimeRecorder ScanAssetsTimeRecorder(FString::Printf(TEXT("ScanAssets %d."),Assets.Num()));
 	UE_LOG(LogResScannerProxy,Display,TEXT("Asset Scanning"));
+	PackageTracker.Begin();
+	PeakUsedMemory = 0;
+	BudgetGCNum = 0;
+	// git status of files is queried from one snapshot in this scan
+	FGitStatusSnapshot::ResetAll();
+	UFlibAssetParseHelper::ResetPackageExtensionCache();
+	// last commit of files is persisted with scan cache, it's discarded if HEAD changed
+	FGitLastCommitIndex::ResetAll();
+	FGitLastCommitIndex::SetCacheDir(GetScannerConfig()->bUseScanCache ? UFlibAssetParseHelper::ReplaceMarkPath(GetScannerConfig()->SavePath.Path) : FString());
+	for(const auto& ResultSink:ResultSinks)
+	{
+		ResultSink->BeginScan();
+	}
 	
 	FMatchedResult ScanResult;
-	auto ScanAssetByRule = [this](const TArray<FAssetData>& Assets,const FScannerMatchRule& Rule,int32 RuleID,FRuleMatchedInfo& OutResult)->bool
+	// rule and RuleID, table rules first
+	TArray<TPair<const FScannerMatchRule*,int32>> AllowRules;
+	auto AddAllowRule = [this,&AllowRules](const FScannerMatchRule& Rule,int32 RuleID)
 	{
-		bool bResult = false;
 		bool bIsAllowRule = GetScannerConfig()->IsAllowRule(Rule,RuleID);
 		if(bIsAllowRule)
 		{
-			OutResult = ScanSingleRule(Assets,Rule,RuleID);
-			bResult = !!OutResult.Assets.Num();
+			AllowRules.Emplace(&Rule,RuleID);
 		}
 		UE_LOG(LogResScannerProxy,Display,TEXT("Rule \"%s\" is %s!"),*Rule.RuleName,bIsAllowRule ? TEXT("enabled"):TEXT("disabled"));
-		return bResult;
 	};
 	
+	TArray<FScannerMatchRule> ImportRules;
 	if(GetScannerConfig()->bUseRulesTable)
 	{
-		TArray<FScannerMatchRule> ImportRules = GetScannerConfig()->GetTableRules();
+		ImportRules = GetScannerConfig()->GetTableRules();
 		UE_LOG(LogResScannerProxy,Display,TEXT("Total Rules: %d!"),ImportRules.Num());
 		
 		for(int32 RuleID = 0;RuleID < ImportRules.Num();++RuleID)
 		{
-			const auto& ScanRule = ImportRules[RuleID];
-			FRuleMatchedInfo RuleMatchedInfo;
-			if(ScanAssetByRule(Assets,ScanRule,RuleID,RuleMatchedInfo))
-			{
-				ScanResult.GetMatchedInfo().Add(RuleMatchedInfo);
-			}
-			
+			AddAllowRule(ImportRules[RuleID],RuleID);
 		}
 	}
 	
 	for(int32 RuleID = 0;RuleID < GetScannerConfig()->ScannerRules.Num();++RuleID)
 	{
-		const auto& ScanRule = GetScannerConfig()->ScannerRules[RuleID];
-		FRuleMatchedInfo RuleMatchedInfo;
-		if(ScanAssetByRule(Assets,ScanRule,RuleID,RuleMatchedInfo))
+		AddAllowRule(GetScannerConfig()->ScannerRules[RuleID],RuleID);
+	}
+
+	if(GetScannerConfig()->bUseScanCache)
+	{
+		FString ConfigName = GetScannerConfig()->ConfigName.IsEmpty() ? TEXT("ResScanner") : GetScannerConfig()->ConfigName;
+		FString CacheFile = FPaths::Combine(UFlibAssetParseHelper::ReplaceMarkPath(GetScannerConfig()->SavePath.Path),FString::Printf(TEXT("%s_scancache.json"),*ConfigName));
+		ScanCache = MakeShareable(new FScannerScanCache);
+		ScanCache->Load(CacheFile,GetScannerConfig()->ConfigName);
+		ScanCache->SetSharedDir(UFlibAssetParseHelper::ReplaceMarkPath(GetScannerConfig()->SharedScanCachePath.Path));
+	}
+	
+	// compile all rules once, name/path patterns of all rules share one matcher
+	TSharedPtr<FScannerTextMatcher> TextMatcher = MakeShareable(new FScannerTextMatcher);
+	TArray<TSharedPtr<const FScannerRuleProgram>> Programs;
+	for(const auto& AllowRule:AllowRules)
+	{
+		TSharedPtr<const FScannerRuleProgram> Program = CompileRule(*AllowRule.Key,AllowRule.Value,TextMatcher);
+		if(Program.IsValid())
 		{
-			ScanResult.GetMatchedInfo().Add(RuleMatchedInfo);
+			Programs.Add(Program);
 		}
 	}
+	TextMatcher->Build();
+	
+	// rules with same candidate signature query asset registry once
+	TArray<FString> CandidateSignatures;
+	for(const auto& Program:Programs)
+	{
+		TMultiMap<FName,TOptional<FString>> TagsAndValues;
+		CandidateSignatures.Add(GetCandidateSignature(*Program->Rule,TagsAndValues));
+	}
+	CandidatePlanner.Plan(CandidateSignatures);
+	
+	// class derivation of global assets, shared by all rules
+	FScannerClassIndex GlobalClassIndex;
+	GlobalClassIndex.Build(Assets);
+	
+	if(GetScannerConfig()->bParallelScan || GetScannerConfig()->bAssetMajorScan)
+	{
+		ScanRulesByTask(Assets,GlobalClassIndex,Programs,ScanResult);
+	}
+	else
+	{
+		for(const auto& Program:Programs)
+		{
+			FRuleMatchedInfo RuleMatchedInfo = ScanSingleRule(Assets,GlobalClassIndex,Program);
+			EmitRuleResult(RuleMatchedInfo,ScanResult);
+		}
+	}
+	for(const auto& ResultSink:ResultSinks)
+	{
+		ResultSink->EndScan();
+	}
+	if(ScanCache.IsValid())
+	{
+		ScanCache->Save();
+		ScanCache.Reset();
+	}
+	CandidatePlanner.Reset();
+	AssetSnapshot.Reset();
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	PeakUsedMemory = FMath::Max<uint64>(PeakUsedMemory,PackageTracker.GetUsedMemory());
+	PackageTracker.End();
+	UE_LOG(LogResScannerProxy,Display,TEXT("Scan peak used memory %llu MB(process peak %llu MB), unload packages %d times by memory budget."),
+		PeakUsedMemory / 1024 / 1024,MemoryStats.PeakUsedPhysical / 1024 / 1024,BudgetGCNum);
 	return ScanResult;
 }
 
@@ -0,0 +1,34 @@
+#include "FScannerPathIndex.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FScannerPathPrefixTrieEmptyTest,"ResScanner.PathIndex.EmptyDirectory",EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FScannerPathPrefixTrieEmptyTest::RunTest(const FString& Parameters)
+{
+	FDirectoryPath EmptyDirectory;
+	FDirectoryPath GameDirectory;
+	GameDirectory.Path = TEXT("/Game/Foo");
+
+	FScannerPathPrefixTrie EmptyTrie;
+	EmptyTrie.Add(TArray<FDirectoryPath>{EmptyDirectory});
+	TestTrue(TEXT("only empty directory is empty trie"),EmptyTrie.IsEmpty());
+	TestFalse(TEXT("empty directory matches nothing"),EmptyTrie.MatchAnyPrefix(FName(TEXT("/Game/Foo/Bar"))));
+
+	FScannerPathPrefixTrie Trie;
+	Trie.Add(TArray<FDirectoryPath>{EmptyDirectory,GameDirectory});
+	TestTrue(TEXT("same as StartsWith"),Trie.MatchAnyPrefix(FName(TEXT("/Game/Foobar"))));
+	TestTrue(TEXT("case insensitive"),Trie.MatchAnyPrefix(FName(TEXT("/game/foo/Bar"))));
+	TestFalse(TEXT("empty directory is skipped"),Trie.MatchAnyPrefix(FName(TEXT("/Game/Other"))));
+
+	FAssetFilters IgnoreRule;
+	IgnoreRule.Filters.Add(EmptyDirectory);
+	FScannerIgnoreIndex IgnoreIndex;
+	IgnoreIndex.Build(TArray<FAssetFilters>{IgnoreRule});
+	FAssetData AssetData(FName(TEXT("/Game/Foo/Bar")),FName(TEXT("/Game/Foo")),FName(TEXT("Bar")),FName(TEXT("Texture2D")));
+	TestFalse(TEXT("empty ignore directory ignores nothing"),IgnoreIndex.IsIgnored(AssetData));
+	return true;
+}
+
+#endif
@@ -106,9 +106,9 @@ UENUM(BlueprintType)
 enum class EPropertyMatchRule:uint8
 {
 	Equal UMETA(DisplayName="等于"),
-	NotEqual UMETA(DisplayName="不等于")
-	// LessThan UMETA(DisplayName="小于"),
-	// GreatThan UMETA(DisplayName="大于")
+	NotEqual UMETA(DisplayName="不等于"),
+	LessThan UMETA(DisplayName="小于"),
+	GreaterThan UMETA(DisplayName="大于")
 };
 
 USTRUCT(BlueprintType)
@@ -286,6 +286,8 @@ public:
 	virtual EMatchLogic GetMatchLogic_Implementation()const { return EMatchLogic::Necessary; };
 
 	bool IsFastMatch()const { return bFastMatch; }
+	// native MatchFast_Implementation can be called in worker threads, opt-in by operator
+	virtual bool IsThreadSafeFastMatch()const { return false; }
 protected:
 	// do not load asset,will be call MatchFast just pass LongPackageName
 	UPROPERTY(EditAnywhere,BlueprintReadWrite)
@@ -383,6 +385,17 @@ public:
 	FString EndCommitHash = TEXT("HEAD");
 	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="检查待提交文件",Category="GitChecker",meta=(EditCondition="bGitCheck && !bDiffCommit"))
 	bool bUncommitFiles = false;
+	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="最大并发Git进程数",Category="GitChecker",meta=(EditCondition="bGitCheck",ClampMin=1))
+	int32 MaxGitProcesses = 4;
+	// 把修改的资源沿引用关系扩展到引用它们的资源(如父材质修改时扫描其材质实例)
+	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="扫描引用修改资源的资源",Category="GitChecker",meta=(EditCondition="bGitCheck"))
+	bool bExpandReferencers = false;
+	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="引用扩展深度",Category="GitChecker",meta=(EditCondition="bGitCheck && bExpandReferencers",ClampMin=1))
+	int32 ReferencerDepth = 1;
+	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="硬引用",Category="GitChecker",meta=(EditCondition="bGitCheck && bExpandReferencers"))
+	bool bHardReferencers = true;
+	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="软引用",Category="GitChecker",meta=(EditCondition="bGitCheck && bExpandReferencers"))
+	bool bSoftReferencers = false;
 
 	FString GetRepoDir()const;
 };
@@ -450,14 +463,49 @@ public:
 	bool bSaveResult = true;
 	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="简洁扫描结果",Category="Save",meta=(EditCondition="bSaveResult"))
 	bool bSavaeLiteResult = true;
+	// 每个规则扫描完成后立即写入结果文件(简洁格式为txt，否则为每行一个json的ndjson)，返回的结果中只保留规则信息
+	// 资源优先单遍扫描时所有规则在单遍扫描结束后才写入
+	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="流式输出扫描结果",Category="Save",meta=(EditCondition="bSaveResult"))
+	bool bStreamResult = false;
 	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="存储路径",Category="Save")
 	FDirectoryPath SavePath;
+	// 在存储路径中记录资源与规则的匹配结果，资源和规则都未修改时直接使用上次的结果
+	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="增量扫描缓存",Category="Save")
+	bool bUseScanCache = false;
+	// 多台机器共享的缓存目录(如网络共享目录)，按资源内容Hash与规则Hash存取匹配结果，只匹配其他机器未扫描过的资源，为空则不共享
+	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="共享扫描缓存目录",Category="Save",meta=(EditCondition="bUseScanCache"))
+	FDirectoryPath SharedScanCachePath;
 	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="独立运行模式",Category="Advanced")
 	bool bStandaloneMode = true;
+	// 独立运行模式下优先把扫描提交到本机常驻的扫描服务(-run=ResScanner -ScanServer -ServerPort=N)，连接失败时启动新进程，0为不使用
+	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="常驻扫描服务端口",Category="Advanced",meta=(EditCondition="bStandaloneMode",ClampMin=0,ClampMax=65535))
+	int32 ScanServerPort = 0;
 	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="关闭Shader编译",Category="Advanced")
 	bool bNoShaderCompile = true;
 	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="输出详细日志",Category="Advanced")
 	bool bVerboseLog = false;
+	// 规则与资源分块并行匹配，需要加载资源的规则仍在游戏线程中执行
+	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="并行扫描",Category="Advanced")
+	bool bParallelScan = false;
+	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="并行任务资源数",Category="Advanced",meta=(EditCondition="bParallelScan",ClampMin=1))
+	int32 ParallelBatchSize = 256;
+	// 命令行扫描时按包名把资源分片，启动多个ResScanner进程从本地队列领取剩余分片扫描，最后合并结果，小于2时不启用
+	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="多进程扫描进程数",Category="Advanced",meta=(ClampMin=0))
+	int32 WorkerProcessNum = 0;
+	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="每进程分片数",Category="Advanced",meta=(EditCondition="WorkerProcessNum > 1",ClampMin=1))
+	int32 ShardsPerWorker = 4;
+	// 合并所有规则的资源，每个资源只加载一次并匹配所有规则
+	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="资源优先单遍扫描",Category="Advanced")
+	bool bAssetMajorScan = false;
+	// 每加载N个资源卸载一次扫描加载的资源，0为不执行
+	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="GC间隔资源数",Category="Advanced",meta=(EditCondition="bAssetMajorScan",ClampMin=0))
+	int32 AssetMajorGCInterval = 200;
+	// 匹配需要加载资源的规则时，提前异步加载后续N个资源，匹配完成后分批释放，0为不预加载
+	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="异步预加载资源数",Category="Advanced",meta=(ClampMin=0))
+	int32 PreloadPackageNum = 0;
+	// 扫描开始后增加的内存超过预算(MB)时卸载扫描加载的资源，0为不限制
+	UPROPERTY(EditAnywhere,BlueprintReadWrite,DisplayName="内存预算(MB)",Category="Advanced",meta=(ClampMin=0))
+	int32 MemoryBudgetMB = 0;
 	
 	UPROPERTY(EditAnywhere,BlueprintReadWrite,Category="Advanced")
 	FString AdditionalExecCommand;
@@ -489,6 +537,8 @@ public:
 	bool HasValidResult()const;
 	TArray<FRuleMatchedInfo>& GetMatchedInfo(){ return MatchedAssets; }
 	const TArray<FRuleMatchedInfo>& GetMatchedInfo()const { return MatchedAssets; }
+	// matched assets of same rule are appended, every shard result keeps all rules in scan order
+	static FMatchedResult MergeShards(const TArray<FMatchedResult>& ShardResults);
 protected:
 	FString SerializeLiteResult()const;
 	UPROPERTY(EditAnywhere,BlueprintReadWrite)
@@ -0,0 +1,34 @@
+#pragma once
+#include "FScannerTextMatcher.h"
+#include "AssetData.h"
+#include "CoreMinimal.h"
+
+// candidate assets of all rules in one scan, every asset is added once and shared by all rules
+// strings for matching are computed once in contiguous arrays, instead of FName::ToString per rule
+struct RESSCANNER_API FScannerAssetSnapshot
+{
+	// OutIndices[i] is the snapshot index of Assets[i], must be called in GameThread
+	void Add(const TArray<FAssetData>& Assets,TArray<int32>& OutIndices);
+	// compute assets added after last Build in parallel, TextMatcher can be nullptr
+	void Build(const FScannerTextMatcher* InTextMatcher);
+	void Reset();
+	int32 Num()const { return ObjectPaths.Num(); }
+
+	// nullptr if not built by InTextMatcher
+	const FScannerTextMatchBits* GetMatchBits(int32 Index,const FScannerTextMatcher* InTextMatcher)const
+	{
+		return (InTextMatcher && InTextMatcher == TextMatcher && Index < BuiltNum) ? &TextMatchBits[Index] : nullptr;
+	}
+
+	TArray<FName> ObjectPaths;
+	TArray<FString> LowerAssetNames;
+	TArray<FString> LowerObjectPaths;
+	TArray<FString> PackageNames;
+	TArray<FScannerTextMatchBits> TextMatchBits;
+protected:
+	TMap<FName,int32> ObjectPathIndices;
+	// source asset of new added, cleared in Build
+	TArray<const FAssetData*> PendingAssets;
+	const FScannerTextMatcher* TextMatcher = nullptr;
+	int32 BuiltNum = 0;
+};
@@ -0,0 +1,28 @@
+#pragma once
+#include "FMatchRuleTypes.h"
+#include "AssetData.h"
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+
+// rules with same candidate signature share one candidate array, the query runs once per signature
+class RESSCANNER_API FScannerCandidatePlanner
+{
+public:
+	// count rules of every signature, the candidate set is released after the last rule acquired it
+	void Plan(const TArray<FString>& Signatures);
+	// Query runs if the set of signature is not built yet, not planned signature is not shared
+	TSharedPtr<const TArray<FAssetData>> Acquire(const FString& Signature,TFunctionRef<TArray<FAssetData>()> Query);
+	void Reset();
+
+	// everything decides the candidate assets of rule
+	static FString GetSignature(const FScannerMatchRule& Rule,bool bGlobalAssets,bool bRegistryAssets,const TMultiMap<FName,TOptional<FString>>& TagsAndValues);
+protected:
+	struct FCandidateSet
+	{
+		TSharedPtr<const TArray<FAssetData>> Assets;
+		int32 RemainingRules = 0;
+	};
+	TMap<FString,FCandidateSet> CandidateSets;
+	int32 QueryNum = 0;
+	int32 SharedNum = 0;
+};
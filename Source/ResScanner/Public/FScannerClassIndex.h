@@ -0,0 +1,31 @@
+#pragma once
+#include "AssetData.h"
+#include "CoreMinimal.h"
+
+// class derivation index of assets, build once per scan
+// every class has a compact ID, ancestor IDs are always less than child ID
+struct RESSCANNER_API FScannerClassIndex
+{
+	void Build(const TArray<FAssetData>& Assets);
+	void AddAssetClass(FName ClassName);
+	void Reset();
+
+	// INDEX_NONE if the class is not found
+	int32 FindClassID(FName AssetClassName)const;
+	int32 FindClassID(const UClass* Class)const;
+	bool IsChildOf(int32 ClassID,int32 ParentClassID)const
+	{
+		const TBitArray<>& ClassAncestors = Ancestors[ClassID];
+		return ParentClassID < ClassAncestors.Num() && ClassAncestors[ParentClassID];
+	}
+	bool Contains(FName AssetClassName)const { return AssetClassIDs.Contains(AssetClassName); }
+
+protected:
+	int32 AddClass(const UClass* Class);
+
+	// asset class name to class ID, INDEX_NONE if not found the UClass
+	TMap<FName,int32> AssetClassIDs;
+	TMap<const UClass*,int32> ClassIDs;
+	// bit of self and all super classes
+	TArray<TBitArray<>> Ancestors;
+};
@@ -0,0 +1,51 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "UObject/StrongObjectPtr.h"
+
+// async load the next N packages of the matching sequence while matching current package
+// loaded packages are referenced until released in batches, must be used in GameThread
+class RESSCANNER_API FScannerPackagePreloader
+{
+public:
+	FScannerPackagePreloader(const TArray<FName>& InPackageNames,int32 InPreloadNum);
+	~FScannerPackagePreloader();
+
+	// request packages of [Index,Index+PreloadNum] and wait the package of Index loaded
+	void Prepare(int32 Index);
+	// the package of Index is matched, release matched packages every PreloadNum
+	void Finish(int32 Index);
+	// release matched packages now, packages of the next window are kept for matching
+	void ReleaseFinished();
+	void ReleaseAll();
+
+protected:
+	struct FPreloadState
+	{
+		TMap<FName,TStrongObjectPtr<UPackage>> LoadedPackages;
+	};
+	TArray<FName> PackageNames;
+	int32 PreloadNum = 0;
+	int32 RequestedNum = 0;
+	TMap<FName,int32> RequestIDs;
+	TArray<FName> FinishedPackages;
+	// shared with load callbacks, the callback may be called after preloader destroyed
+	TSharedRef<FPreloadState> State;
+};
+
+// editor keeps RF_Standalone assets in GC, packages loaded by scanning must clear the flag to be unloaded
+// must be used in GameThread
+class RESSCANNER_API FScannerPackageTracker
+{
+public:
+	// packages loaded before Begin are never unloaded, e.g. opened assets of editor
+	void Begin();
+	void End();
+	// clear RF_Standalone of packages loaded after Begin and collect garbage, referenced packages are kept by GC
+	int32 UnloadPackages();
+	// used physical memory after Begin
+	uint64 GetUsedMemory()const;
+
+protected:
+	TSet<FName> InitialPackages;
+	uint64 InitialUsedMemory = 0;
+};
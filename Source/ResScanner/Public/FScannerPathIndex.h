@@ -0,0 +1,38 @@
+#pragma once
+#include "FMatchRuleTypes.h"
+#include "AssetData.h"
+#include "CoreMinimal.h"
+
+// case insensitive string prefix trie, same as FString::StartsWith
+struct RESSCANNER_API FScannerPathPrefixTrie
+{
+	void Add(const FString& Prefix);
+	void Add(const TArray<FDirectoryPath>& Directorys);
+	bool IsEmpty()const { return !Nodes.Num(); }
+	// true if any added prefix is the prefix of Text
+	bool MatchAnyPrefix(const TCHAR* Text,int32 Len)const;
+	bool MatchAnyPrefix(FName Text)const;
+
+protected:
+	struct FNode
+	{
+		// lower case char and node index
+		TArray<TPair<TCHAR,int32>> Children;
+		bool bTerminal = false;
+	};
+	int32 FindChild(int32 NodeIndex,TCHAR Char)const;
+	TArray<FNode> Nodes;
+};
+
+// compiled FAssetFilters, same as UFlibAssetParseHelper::IsIgnoreAsset
+struct RESSCANNER_API FScannerIgnoreIndex
+{
+	void Build(const TArray<FAssetFilters>& IgnoreRules);
+	bool IsIgnored(const FAssetData& AssetData)const;
+
+protected:
+	FScannerPathPrefixTrie Directorys;
+	TSet<FName> Assets;
+	// asset paths only different in case with Assets, FName is case insensitive
+	TArray<FString> CaseVariantAssets;
+};
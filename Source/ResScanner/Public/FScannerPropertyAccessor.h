@@ -0,0 +1,51 @@
+#pragma once
+#include "FMatchRuleTypes.h"
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+enum class EScannerPropertyKind : uint8
+{
+	Bool,
+	Integer,
+	Float,
+	Double,
+	Enum,
+	Name,
+	String,
+	Object,
+	// compare by ExportTextItem
+	Text
+};
+
+// resolved property path of a class, compare property value with FPropertyMatchMapping natively
+struct RESSCANNER_API FScannerPropertyAccessor
+{
+	// from class property to leaf property, the middle are struct properties
+	TArray<FProperty*> PropertyChain;
+	EScannerPropertyKind Kind = EScannerPropertyKind::Text;
+	UEnum* Enum = nullptr;
+
+	const void* GetValuePtr(const UObject* Object)const;
+	// false if the value is empty or can't be compared by MatchRule
+	bool Match(const UObject* Object,const FPropertyMatchMapping& PropertyRule)const;
+	// Value is exported text, e.g. asset registry tag
+	bool MatchText(const FString& Value,const FPropertyMatchMapping& PropertyRule)const;
+
+	// text compare, LessThan/GreaterThan compare by number if both are numeric
+	static bool CompareText(const FString& Value,const FString& MatchValue,EPropertyMatchRule MatchRule);
+protected:
+	int64 GetEnumValue(const FString& MatchValue)const;
+	mutable TMap<FString,int64> EnumValues;
+};
+
+// accessors by (class, property path), must be used in GameThread
+class RESSCANNER_API FScannerPropertyAccessorCache
+{
+public:
+	// PropertyPath is property name or StructProperty.MemberName, nullptr if not found
+	const FScannerPropertyAccessor* Find(const UClass* Class,const FString& PropertyPath);
+	void Reset(){ Accessors.Empty(); }
+protected:
+	// not found property is cached as nullptr
+	TMap<TPair<FObjectKey,FString>,TSharedPtr<FScannerPropertyAccessor>> Accessors;
+};
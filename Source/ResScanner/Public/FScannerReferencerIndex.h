@@ -0,0 +1,25 @@
+#pragma once
+#include "CoreMinimal.h"
+
+class IAssetRegistry;
+
+// referencers of all packages in asset registry, stored in compressed sparse rows
+// built once, then changed packages are expanded to the packages affected by them without querying asset registry
+struct RESSCANNER_API FScannerReferencerIndex
+{
+	void Build(IAssetRegistry& AssetRegistry,bool bHardReferences,bool bSoftReferences);
+	void Reset();
+	int32 Num()const { return Packages.Num(); }
+
+	// packages reference ChangedPackages directly or indirectly within MaxDepth, ChangedPackages are excluded
+	TArray<FName> Expand(const TArray<FName>& ChangedPackages,int32 MaxDepth)const;
+
+protected:
+	int32 AddPackage(FName PackageName);
+
+	TMap<FName,int32> PackageIndices;
+	TArray<FName> Packages;
+	// referencers of package i are Referencers[Offsets[i],Offsets[i+1])
+	TArray<int32> Offsets;
+	TArray<int32> Referencers;
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include "FMatchRuleTypes.h"
+#include "CoreMinimal.h"
+
+// receive the result of every rule as soon as the rule is finished, rules are emitted by scan order
+class RESSCANNER_API IScannerResultSink
+{
+public:
+	virtual ~IScannerResultSink(){}
+	virtual void BeginScan(){}
+	// RuleMatchedInfo contains AssetsCommiter if record commiter
+	virtual void OnRuleMatched(const FRuleMatchedInfo& RuleMatchedInfo)=0;
+	virtual void EndScan(){}
+};
+
+// write to file and flush every rule, the file can be read while scanning
+class RESSCANNER_API FScannerFileResultSink : public IScannerResultSink
+{
+public:
+	FScannerFileResultSink(const FString& InSaveFile,bool bInRecordCommiter);
+	virtual ~FScannerFileResultSink();
+	virtual void BeginScan()override;
+	virtual void EndScan()override;
+	const FString& GetSaveFile()const { return SaveFile; }
+protected:
+	void WriteString(const FString& Content);
+	FString SaveFile;
+	bool bRecordCommiter = false;
+	TUniquePtr<FArchive> Writer;
+};
+
+// one json object per line: {"RuleName":"","RuleID":0,"Asset":"","Commiter":""}
+class RESSCANNER_API FScannerNDJsonResultSink : public FScannerFileResultSink
+{
+public:
+	using FScannerFileResultSink::FScannerFileResultSink;
+	virtual void OnRuleMatched(const FRuleMatchedInfo& RuleMatchedInfo)override;
+};
+
+// same as FMatchedResult::SerializeResult(true)
+class RESSCANNER_API FScannerLiteResultSink : public FScannerFileResultSink
+{
+public:
+	using FScannerFileResultSink::FScannerFileResultSink;
+	virtual void OnRuleMatched(const FRuleMatchedInfo& RuleMatchedInfo)override;
+	virtual void EndScan()override;
+};
+
+// collect all results in memory, for editor
+class RESSCANNER_API FScannerCollectorResultSink : public IScannerResultSink
+{
+public:
+	virtual void BeginScan()override { Result = FMatchedResult{}; }
+	virtual void OnRuleMatched(const FRuleMatchedInfo& RuleMatchedInfo)override { Result.GetMatchedInfo().Add(RuleMatchedInfo); }
+	const FMatchedResult& GetResult()const { return Result; }
+protected:
+	FMatchedResult Result;
+};
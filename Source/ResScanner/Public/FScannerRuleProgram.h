@@ -0,0 +1,160 @@
+#pragma once
+#include "FMatchRuleTypes.h"
+#include "FScannerPathIndex.h"
+#include "CoreMinimal.h"
+
+struct IMatchOperator;
+class FScannerTextMatcher;
+
+// ENameMatchMode & EPathMatchMode(WithIn is StartWith)
+enum class ECompiledTextMode : uint8
+{
+	StartWith,
+	EndWith,
+	Wildcard
+};
+
+struct RESSCANNER_API FCompiledTextPattern
+{
+	// lower case
+	FString Pattern;
+	bool bReverseCheck = false;
+	// index in FScannerTextMatcher, INDEX_NONE if not registered
+	int32 PatternID = INDEX_NONE;
+};
+
+struct RESSCANNER_API FCompiledTextGroup
+{
+	ECompiledTextMode MatchMode = ECompiledTextMode::Wildcard;
+	EMatchLogic MatchLogic = EMatchLogic::Necessary;
+	int32 OptionalRuleMatchNum = 1;
+	TArray<FCompiledTextPattern> Patterns;
+
+	// LowerText must be lower case
+	bool Match(const FString& LowerText)const;
+	// LowerText is not required null terminated, no heap allocation
+	bool Match(const TCHAR* LowerText,int32 Len)const;
+	// MatchedPatterns is the result of FScannerPatternMatcher, indexed by PatternID
+	bool Match(const TBitArray<>& MatchedPatterns)const;
+	static bool MatchPattern(ECompiledTextMode MatchMode,const FString& LowerText,const FString& LowerPattern);
+	static bool MatchPattern(ECompiledTextMode MatchMode,const TCHAR* LowerText,int32 Len,const FString& LowerPattern);
+	// case sensitive, same result as FString::MatchesWildcard(including '?' in the middle) without copying strings
+	static bool MatchesWildcard(const TCHAR* Text,int32 TextLen,const TCHAR* Wildcard,int32 WildcardLen);
+
+	template<typename TPatternMatcher>
+	bool MatchBy(const TPatternMatcher& IsPatternMatched)const
+	{
+		const int32 PatternNum = Patterns.Num();
+		int32 OptionalMatchNum = 0;
+		for(int32 Index = 0;Index < PatternNum;++Index)
+		{
+			const FCompiledTextPattern& Pattern = Patterns[Index];
+			bool bMatchResult = IsPatternMatched(Pattern);
+			if(Pattern.bReverseCheck)
+			{
+				bMatchResult = !bMatchResult;
+			}
+			if(bMatchResult)
+			{
+				OptionalMatchNum++;
+			}
+			if(MatchLogic == EMatchLogic::Necessary)
+			{
+				if(!bMatchResult)
+				{
+					return false;
+				}
+			}
+			// Optional中匹配成功的数量必须与配置的一致
+			else if(OptionalMatchNum > OptionalRuleMatchNum || OptionalMatchNum + (PatternNum - Index - 1) < OptionalRuleMatchNum)
+			{
+				return false;
+			}
+		}
+		return (MatchLogic == EMatchLogic::Necessary) ? true : (OptionalRuleMatchNum == OptionalMatchNum);
+	}
+};
+
+struct RESSCANNER_API FCompiledTextRule
+{
+	TArray<FCompiledTextGroup> Groups;
+	bool bReverseCheck = false;
+
+	bool IsEmpty()const { return !Groups.Num(); }
+	bool Match(const FString& LowerText)const;
+	bool Match(const TCHAR* LowerText,int32 Len)const;
+	bool Match(const TBitArray<>& MatchedPatterns)const;
+	// lower case Name into Buffer without heap allocation, return length
+	static int32 ToLowerBuffer(FName Name,TCHAR* Buffer,int32 BufferSize);
+	// register all patterns to the matcher
+	void RegisterPatterns(class FScannerPatternMatcher& Matcher);
+
+	template<typename TGroupMatcher>
+	bool MatchBy(const TGroupMatcher& IsGroupMatched)const
+	{
+		bool bIsMatched = true;
+		for(const auto& Group:Groups)
+		{
+			bIsMatched = IsGroupMatched(Group);
+			if(!bIsMatched)
+			{
+				break;
+			}
+		}
+		if(Groups.Num())
+		{
+			bIsMatched = bReverseCheck ? !bIsMatched : bIsMatched;
+		}
+		return bIsMatched;
+	}
+
+	static FCompiledTextRule Compile(const FNameMatchRule& NameMatchRule);
+	static FCompiledTextRule Compile(const FPathMatchRule& PathMatchRule);
+};
+
+// reject rate of operators in scanning, operators are ordered by cost and then reject rate
+// not thread safe, every lane/task use self instance
+struct RESSCANNER_API FScannerOperatorSelectivity
+{
+	void Init(const TArray<TSharedPtr<IMatchOperator>>& Operators,const FScannerMatchRule& Rule);
+	// index of Operators
+	const TArray<int32>& GetOrder()const { return Order; }
+	void Record(int32 OperatorIndex,bool bMatched);
+	// reorder every ReorderInterval assets
+	void FinishAsset();
+protected:
+	void Reorder();
+	static constexpr int32 ReorderInterval = 64;
+	TArray<int32> Order;
+	TArray<uint8> Costs;
+	TArray<int32> EvaluatedNum;
+	TArray<int32> RejectedNum;
+	int32 AssetNum = 0;
+};
+
+// FScannerMatchRule compiled once before scanning, it's immutable in scanning
+struct RESSCANNER_API FScannerRuleProgram
+{
+	// name/path patterns are registered to TextMatcher if it's valid, TextMatcher must be built after all rules compiled
+	static TSharedPtr<FScannerRuleProgram> Compile(const FScannerMatchRule& Rule,int32 RuleID,const FScannerConfig& Config,const TMap<FString,TSharedPtr<IMatchOperator>>& MatchOperators,const TSharedPtr<FScannerTextMatcher>& TextMatcher = nullptr);
+
+	const FScannerMatchRule* Rule = nullptr;
+	int32 RuleID = 0;
+	// GlobalIgnoreFilters & IgnoreFilters of rule
+	FScannerIgnoreIndex IgnoreIndex;
+
+	FCompiledTextRule NameRule;
+	FCompiledTextRule PathRule;
+	// shared by all rules in scanning
+	TSharedPtr<FScannerTextMatcher> TextMatcher;
+	// CDO of CustomRules
+	TArray<UOperatorBase*> CustomOperators;
+	FString CommiterRepoDir;
+	bool bCommiterRepoExists = false;
+
+	// operators has rules and sorted by cost, ParallelOperators can be call out of GameThread
+	TArray<TSharedPtr<IMatchOperator>> ParallelOperators;
+	TArray<TSharedPtr<IMatchOperator>> GameThreadOperators;
+	// any of GameThreadOperators will load asset
+	bool bNeedLoadAsset = false;
+};
@@ -0,0 +1,97 @@
+#pragma once
+#include "FMatchRuleTypes.h"
+#include "CoreMinimal.h"
+#include "FScannerScanCache.generated.h"
+
+USTRUCT()
+struct FScanCachePackage
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	UPROPERTY()
+	int64 Size = 0;
+	UPROPERTY()
+	FString Timestamp;
+	UPROPERTY()
+	FString Hash;
+};
+
+USTRUCT()
+struct FScanCacheResult
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	UPROPERTY()
+	bool bMatched = false;
+	// package hash when matching
+	UPROPERTY()
+	FString Hash;
+};
+
+USTRUCT()
+struct FScanCacheRule
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	UPROPERTY()
+	FString ConfigName;
+	UPROPERTY()
+	FString RuleName;
+	// object path to match result
+	UPROPERTY()
+	TMap<FString,FScanCacheResult> Results;
+};
+
+USTRUCT()
+struct FScanCacheData
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	UPROPERTY()
+	int32 Version = 0;
+	// long package name to package file info
+	UPROPERTY()
+	TMap<FString,FScanCachePackage> Packages;
+	// rule fingerprint to rule results
+	UPROPERTY()
+	TMap<FString,FScanCacheRule> Rules;
+};
+
+// match result of (asset, rule) in last scans, reuse it when package and rule both not changed
+// results can be shared between machines by a directory, keyed by (rule fingerprint, package content hash, object path)
+class RESSCANNER_API FScannerScanCache
+{
+public:
+	// results of other configs in same cache file are kept
+	bool Load(const FString& InCacheFile,const FString& InConfigName);
+	// also write new results to shared directory
+	bool Save();
+	// empty to disable shared results
+	void SetSharedDir(const FString& InSharedDir);
+
+	// empty if the rule can't be cached(result not only depends on asset and rule)
+	static FString GetRuleFingerprint(const FScannerMatchRule& Rule);
+	// hash packages of assets, must be called in GameThread before FindResult
+	void PreparePackages(const TArray<FAssetData>& Assets);
+	// read only, can be called out of GameThread
+	bool FindResult(const FString& RuleFingerprint,const FAssetData& Asset,bool& bOutMatched)const;
+	void AddResult(const FString& RuleFingerprint,const FString& RuleName,const FAssetData& Asset,bool bMatched);
+	// fetch results not in local cache from shared directory, must be called in GameThread after PreparePackages
+	void FetchSharedResults(const FString& RuleFingerprint,const FString& RuleName,const TArray<FAssetData>& Assets);
+
+protected:
+	bool AddLocalResult(const FString& RuleFingerprint,const FString& RuleName,const FAssetData& Asset,bool bMatched);
+	FString GetSharedFile(const FString& RuleFingerprint,const FString& PackageHash,FName ObjectPath)const;
+	void FlushSharedResults();
+
+	FString CacheFile;
+	FString ConfigName;
+	FString SharedDir;
+	// shared file to match result, written in Save
+	TArray<TPair<FString,bool>> PendingSharedResults;
+	int32 SharedHitNum = 0;
+	FScanCacheData CacheData;
+	// hash of package file in this scan, empty if package file not found
+	TMap<FName,FString> PackageHashes;
+	TSet<FString> UsedRules;
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include "FScannerRuleProgram.h"
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+
+struct FScannerAssetContext;
+
+// all patterns of one text(name or path) in one automaton, match once get results of all patterns
+// StartWith: prefix trie, EndWith: suffix trie
+// Wildcard: Aho-Corasick by the longest literal of pattern, verify candidates by FCompiledTextGroup::MatchesWildcard
+class RESSCANNER_API FScannerPatternMatcher
+{
+public:
+	// LowerPattern must be lower case, same patterns has same ID
+	int32 AddPattern(ECompiledTextMode Mode,const FString& LowerPattern);
+	void Build();
+	int32 Num()const { return Patterns.Num(); }
+	// LowerText must be lower case, OutMatched is indexed by PatternID
+	void Match(const FString& LowerText,TBitArray<>& OutMatched)const;
+	void Match(const TCHAR* LowerText,int32 Len,TBitArray<>& OutMatched)const;
+
+protected:
+	struct FNode
+	{
+		TArray<TPair<TCHAR,int32>> Children;
+		TArray<int32> PatternIDs;
+		// Aho-Corasick only
+		int32 Fail = 0;
+		int32 OutputLink = INDEX_NONE;
+	};
+	static int32 FindChild(const TArray<FNode>& Nodes,int32 NodeIndex,TCHAR Char);
+	static int32 AddString(TArray<FNode>& Nodes,const TCHAR* Str,int32 Len,bool bReverse);
+	static FString GetLongestLiteral(const FString& WildcardPattern);
+
+	TArray<TPair<ECompiledTextMode,FString>> Patterns;
+	TMap<FString,int32> PatternIDs[3];
+
+	TArray<FNode> PrefixNodes;
+	TArray<FNode> SuffixNodes;
+	TArray<FNode> WildcardNodes;
+	// wildcard without literal, e.g. "*"
+	TArray<int32> AlwaysCheckWildcards;
+	bool bBuilt = false;
+};
+
+struct RESSCANNER_API FScannerTextMatchBits
+{
+	TBitArray<> NameBits;
+	TBitArray<> PathBits;
+};
+
+// patterns of all rules in scanning, and matched patterns cache of assets
+class RESSCANNER_API FScannerTextMatcher
+{
+public:
+	void Build();
+	// thread safe after Build
+	const FScannerTextMatchBits& GetMatchBits(FScannerAssetContext& Context);
+
+	FScannerPatternMatcher NameMatcher;
+	FScannerPatternMatcher PathMatcher;
+
+protected:
+	FRWLock CacheLock;
+	TMap<FName,TSharedPtr<const FScannerTextMatchBits,ESPMode::ThreadSafe>> MatchBitsCache;
+};
@@ -4,6 +4,7 @@
 #include "AssetData.h"
 #include "CoreMinimal.h"
 #include "FMatchRuleTypes.h"
+#include "FScannerPropertyAccessor.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "Widgets/Notifications/SNotificationList.h"
 #include "FlibAssetParseHelper.generated.h"
@@ -23,11 +24,16 @@ public:
 	UFUNCTION(BlueprintCallable)
 	static FString GetPropertyValueByName(UObject* Obj,const FString& PropertyName);
 	static TArray<FAssetData> GetAssetsByFiltersByClass(const TArray<UClass*>& AssetTypes, const TArray<FDirectoryPath>& FilterDirectorys, bool bRecursiveClasses = true);
+	// asset passes if any of TagsAndValues is matched by tag text, asset without the tag is passed because the tag may be not saved yet
+	static TArray<FAssetData> GetAssetsByFiltersByClass(const TArray<UClass*>& AssetTypes, const TArray<FDirectoryPath>& FilterDirectorys, bool bRecursiveClasses,const TMultiMap<FName,TOptional<FString>>& TagsAndValues);
 	static TArray<FAssetData> GetAssetsByFilters(const TArray<FString>& AssetTypes,const TArray<FDirectoryPath>& FilterDirectorys, bool bRecursiveClasses=true);
 	static TArray<FAssetData> GetAssetsByFilters(const TArray<FString>& AssetTypes,const TArray<FString>& FilterPaths, bool bRecursiveClasses=true);
+	static TArray<FAssetData> GetAssetsByFilters(const TArray<FString>& AssetTypes,const TArray<FString>& FilterPaths, bool bRecursiveClasses,const TMultiMap<FName,TOptional<FString>>& TagsAndValues);
 	static TArray<FAssetData> GetAssetsByObjectPath(const TArray<FSoftObjectPath>& SoftObjectPaths);
 	static TArray<FAssetData> GetAssetsWithCachedByTypes(const TArray<FAssetData>& CachedAssets, const TArray<UClass*>& AssetTypes,bool bUseFilter,const TArray<FDirectoryPath>& FilterDirectorys,bool bRecursiveClasses = true);
 	static TArray<FAssetData> GetAssetsWithCachedByTypes(const TArray<FAssetData>& CachedAssets, const TArray<FString>& AssetTypes,bool bUseFilter,const TArray<FDirectoryPath>& FilterDirectorys,bool bRecursiveClasses = true);
+	// ClassIndex must contains all asset classes of CachedAssets
+	static TArray<FAssetData> GetAssetsWithCachedByTypes(const TArray<FAssetData>& CachedAssets,const struct FScannerClassIndex& ClassIndex, const TArray<FString>& AssetTypes,bool bUseFilter,const TArray<FDirectoryPath>& FilterDirectorys,bool bRecursiveClasses = true);
 	static class IAssetRegistry& GetAssetRegistry(bool bSearchAllAssets = false);
 	static bool IsIgnoreAsset(const FAssetData& AssetData,const TArray<FAssetFilters>& IgnoreRules);
 	
@@ -37,12 +43,22 @@ public:
 	static TArray<FSoftObjectPath> GetAssetsByGitChecker(const FGitChecker& GitChecker,const FString& GitBinaryOpt = TEXT("git"));
 	static TArray<FSoftObjectPath> GetAssetsByGitCommitHash(const FString& RepoDir,const FString& BeginHash,const FString& EndHand,const FString& GitBinaryOpt = TEXT("git"));
 	static TArray<FSoftObjectPath> GetAssetsByGitStatus(const FString& RepoDir,const FString& GitBinaryOpt = TEXT("git"));
+	// assets of packages reference ChangedAssets within ReferencerDepth, ChangedAssets are excluded
+	static TArray<FSoftObjectPath> GetReferencerAssets(const TArray<FSoftObjectPath>& ChangedAssets,const FGitChecker& GitChecker);
+	// only .uasset and .umap files, without duplicates
+	static TArray<FString> FilterPackageFiles(const TArray<FString>& Files);
 	
 	static void CheckMatchedAssetsCommiter(FMatchedResult& MatchedResult, const FString& RepoDir);
 
 	static FString LongPackageNameToPackagePath(const FString& InPackageName);
 
+	// .umap or .uasset from asset registry or the file on disk, the package is not loaded
 	static FString GetPackageExtensionByLongPackageName(const FString& LongPackageName);
+	static TArray<FString> GetPackageExtensionsByLongPackageNames(const TArray<FString>& LongPackageNames);
+	// absolute filename of the package
+	static FString GetPackageFilenameByLongPackageName(const FString& LongPackageName);
+	static TArray<FString> GetPackageFilenamesByLongPackageNames(const TArray<FString>& LongPackageNames);
+	static void ResetPackageExtensionCache();
 	
 	UFUNCTION(BlueprintCallable,BlueprintPure)
 	static bool GetLongPackageNameByObject(UObject* Obj,FString& OutLongPackageName);
@@ -67,39 +83,121 @@ public:
 
 
 
+struct FScannerRuleProgram;
+
+// asset in matching, the UObject is loaded at most once and shared by all operators/rules
+struct RESSCANNER_API FScannerAssetContext
+{
+	explicit FScannerAssetContext(const FAssetData& InAssetData):AssetData(InAssetData){}
+	FScannerAssetContext(const FAssetData& InAssetData,const struct FScannerAssetSnapshot* InSnapshot,int32 InSnapshotIndex)
+		:AssetData(InAssetData),Snapshot(InSnapshot),SnapshotIndex(InSnapshotIndex){}
+	UObject* GetAsset();
+	bool IsLoaded()const { return bLoaded; }
+	void Release();
+	// lower case AssetName/ObjectPath, for compiled text rules
+	const FString& GetLowerAssetName();
+	const FString& GetLowerObjectPath();
+	
+	const FAssetData& AssetData;
+	// precomputed strings and text match bits, nullptr if the asset is not in snapshot
+	const struct FScannerAssetSnapshot* Snapshot = nullptr;
+	int32 SnapshotIndex = INDEX_NONE;
+	// cached by FScannerTextMatcher
+	TSharedPtr<const struct FScannerTextMatchBits,ESPMode::ThreadSafe> TextMatchBits;
+protected:
+	UObject* LoadedAsset = nullptr;
+	bool bLoaded = false;
+	FString LowerAssetName;
+	FString LowerObjectPath;
+};
+
+// cost to match one asset, cheaper operators are matched first
+enum class EMatchOperatorCost : uint8
+{
+	// only use FAssetData/asset registry
+	RegistryOnly,
+	NeedLoad,
+	SpawnProcess
+};
+
 struct IMatchOperator
 {
 	virtual bool Match(const FAssetData& AssetData,const FScannerMatchRule& Rule)=0;
+	// operators need UObject should override it, use Context.GetAsset() to get loaded asset
+	virtual bool Match(FScannerAssetContext& Context,const FScannerMatchRule& Rule){ return Match(Context.AssetData,Rule); }
+	// match by compiled rule, it's called in scanning
+	virtual bool Match(FScannerAssetContext& Context,const FScannerRuleProgram& Program);
 	virtual FString GetOperatorName()=0;
+	// true if Match can be called out of GameThread(not load any UObject)
+	virtual bool IsThreadSafe(const FScannerMatchRule& Rule)const { return false; }
+	// false if the rule not contain any config of this operator(always matched)
+	virtual bool HasRules(const FScannerMatchRule& Rule)const { return true; }
+	// true if Match will load the asset, the package can be preloaded before matching
+	virtual bool NeedLoadAsset(const FScannerMatchRule& Rule)const { return false; }
+	virtual EMatchOperatorCost GetCost(const FScannerMatchRule& Rule)const { return NeedLoadAsset(Rule) ? EMatchOperatorCost::NeedLoad : EMatchOperatorCost::RegistryOnly; }
 	virtual ~IMatchOperator(){};
 };
 
 struct NameMatchOperator:public IMatchOperator
 {
+	using IMatchOperator::Match;
 	virtual bool Match(const FAssetData& AssetData,const FScannerMatchRule& Rule);
+	virtual bool Match(FScannerAssetContext& Context,const FScannerRuleProgram& Program);
 	virtual FString GetOperatorName(){ return TEXT("NameMatchRule");};
+	virtual bool IsThreadSafe(const FScannerMatchRule& Rule)const { return true; }
+	virtual bool HasRules(const FScannerMatchRule& Rule)const { return !!Rule.NameMatchRules.Rules.Num(); }
 };
 
 struct PathMatchOperator:public IMatchOperator
 {
+	using IMatchOperator::Match;
 	virtual bool Match(const FAssetData& AssetData,const FScannerMatchRule& Rule);
+	virtual bool Match(FScannerAssetContext& Context,const FScannerRuleProgram& Program);
 	virtual FString GetOperatorName(){ return TEXT("PathMatchRule");};
+	virtual bool IsThreadSafe(const FScannerMatchRule& Rule)const { return true; }
+	virtual bool HasRules(const FScannerMatchRule& Rule)const { return !!Rule.PathMatchRules.Rules.Num(); }
 };
 
 struct PropertyMatchOperator:public IMatchOperator
 {
+	using IMatchOperator::Match;
 	virtual bool Match(const FAssetData& AssetData,const FScannerMatchRule& Rule);
+	virtual bool Match(FScannerAssetContext& Context,const FScannerMatchRule& Rule);
 	virtual FString GetOperatorName(){ return TEXT("PropertyMatchRule");};
+	virtual bool HasRules(const FScannerMatchRule& Rule)const { return !!Rule.PropertyMatchRules.MatchRules.Num(); }
+	// not load if all properties are AssetRegistrySearchable of ScanAssetType
+	virtual bool NeedLoadAsset(const FScannerMatchRule& Rule)const;
+	// a necessary Equal of searchable property can be queried by FARFilter, return false if no predicate can be pushed down
+	static bool GetRegistryTagFilter(const FScannerMatchRule& Rule,TMultiMap<FName,TOptional<FString>>& OutTagsAndValues);
+protected:
+	// read from asset registry tag first, load the asset if tag not found
+	bool MatchProperty(FScannerAssetContext& Context,const FPropertyMatchMapping& PropertyRule);
+	static FProperty* FindSearchableProperty(const UClass* Class,const FString& PropertyName);
+	FScannerPropertyAccessorCache AccessorCache;
 };
 
 struct CustomMatchOperator:public IMatchOperator
 {
+	using IMatchOperator::Match;
 	virtual bool Match(const FAssetData& AssetData,const FScannerMatchRule& Rule);
+	virtual bool Match(FScannerAssetContext& Context,const FScannerMatchRule& Rule);
+	virtual bool Match(FScannerAssetContext& Context,const FScannerRuleProgram& Program);
 	virtual FString GetOperatorName(){ return TEXT("ExternalMatchRule");};
+	virtual bool IsThreadSafe(const FScannerMatchRule& Rule)const;
+	virtual bool HasRules(const FScannerMatchRule& Rule)const { return !!Rule.CustomRules.Num(); }
+	virtual bool NeedLoadAsset(const FScannerMatchRule& Rule)const;
+protected:
+	static bool MatchOperators(FScannerAssetContext& Context,const TArray<UOperatorBase*>& Operators);
 };
 
 struct CommiterMatchOperator:public IMatchOperator
 {
+	using IMatchOperator::Match;
 	virtual bool Match(const FAssetData& AssetData,const FScannerMatchRule& Rule);
+	virtual bool Match(FScannerAssetContext& Context,const FScannerRuleProgram& Program);
 	virtual FString GetOperatorName(){ return TEXT("CommiterMatchRule");};
+	virtual bool HasRules(const FScannerMatchRule& Rule)const { return Rule.CommiterMatchRules.bCheckCommiter; }
+	virtual EMatchOperatorCost GetCost(const FScannerMatchRule& Rule)const { return EMatchOperatorCost::SpawnProcess; }
+protected:
+	static bool MatchCommiter(const FAssetData& AssetData,const FCommiterMatchRule& CommiterRule,const FString& RepoRootDir,bool bRepoExists);
 };
\ No newline at end of file
@@ -1,12 +1,48 @@
 #pragma once
 #include "FMatchRuleTypes.h"
 #include "FlibAssetParseHelper.h"
+#include "FScannerRuleProgram.h"
+#include "FScannerClassIndex.h"
+#include "FScannerScanCache.h"
+#include "FScannerResultSink.h"
+#include "FScannerCandidatePlanner.h"
+#include "FScannerAssetSnapshot.h"
+#include "FScannerPackagePreloader.h"
 #include "CoreMinimal.h"
 #include "Templates/SharedPointer.h"
 #include "ResScannerProxy.generated.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogResScannerProxy, Log, All);
 
+enum class EScannerAssetState : uint8
+{
+    // ignored by filters
+    Ignored,
+    // matched by operators
+    Evaluated,
+    // result from scan cache
+    Cached
+};
+
+// one rule prepared for matching: compiled rule and candidate assets
+struct FScannerRuleTask
+{
+    TSharedPtr<const FScannerRuleProgram> Program;
+    // candidate assets, shared by rules with same candidate signature
+    TSharedPtr<const TArray<FAssetData>> CandidateAssets;
+    // index of every candidate in AssetSnapshot
+    TArray<int32> SnapshotIndices;
+    const FScannerAssetSnapshot* AssetSnapshot = nullptr;
+    // match result of every asset, 1 is matched
+    TArray<uint8> MatchedFlags;
+    TArray<EScannerAssetState> AssetStates;
+    // rule fingerprint in scan cache, empty if not use cache
+    FString CacheKey;
+
+    const TArray<FAssetData>& GetAssets()const { return *CandidateAssets; }
+    FScannerAssetContext MakeContext(int32 AssetIndex)const { return FScannerAssetContext(GetAssets()[AssetIndex],AssetSnapshot,SnapshotIndices[AssetIndex]); }
+};
+
 UCLASS(BlueprintType)
 class RESSCANNER_API UResScannerProxy:public UObject
 {
@@ -27,10 +63,62 @@ public:
     virtual TMap<FString,TSharedPtr<IMatchOperator>>& GetMatchOperators(){return MatchOperators;}
     
     FMatchedResult ScanAssets(const TArray<FAssetData>& Assets);
+    // assets by global scan filters and git checker, rules scan them if bByGlobalScanFilters or bGitCheck
+    TArray<FAssetData> GetGlobalAssets();
+    // ConfigName or current time
+    FString GetResultName();
+    // record commiter and save config/result to SavePath, StreamedFile is not empty if the result is streamed to it
+    void SaveScanResult(FMatchedResult& MatchedResult,const FString& Name,const FString& StreamedFile = FString());
+    // only scan packages in shard, shard of package is stable in all processes, InShardNum <= 1 to scan all
+    void SetShard(int32 InShardIndex,int32 InShardNum);
+    bool IsInShard(FName PackageName)const;
+    // sinks receive the result of every rule in ScanAssets
+    void AddResultSink(const TSharedPtr<IScannerResultSink>& ResultSink){ ResultSinks.AddUnique(ResultSink); }
+    void RemoveResultSink(const TSharedPtr<IScannerResultSink>& ResultSink){ ResultSinks.Remove(ResultSink); }
     
 protected:
     virtual void PostProcessorMatchRule(const FScannerMatchRule& Rule,const FRuleMatchedInfo& RuleMatchedInfo);    
+    // check rule is valid and compile it, return nullptr if the rule can't scan
+    TSharedPtr<const FScannerRuleProgram> CompileRule(const FScannerMatchRule& ScannerRule,int32 RuleID,const TSharedPtr<FScannerTextMatcher>& TextMatcher = nullptr);
+    // rules with same signature have same candidate assets
+    FString GetCandidateSignature(const FScannerMatchRule& ScannerRule,TMultiMap<FName,TOptional<FString>>& OutTagsAndValues);
+    // GlobalClassIndex contains asset classes of GlobalAssets
+    void PrepareRuleTask(const TArray<FAssetData>& GlobalAssets,const FScannerClassIndex& GlobalClassIndex,const TSharedPtr<const FScannerRuleProgram>& Program,FScannerRuleTask& OutRuleTask);
+    FRuleMatchedInfo ScanSingleRule(const TArray<FAssetData>& GlobalAssets,const FScannerClassIndex& GlobalClassIndex,const TSharedPtr<const FScannerRuleProgram>& Program);
+    void FinishRuleTask(const FScannerRuleTask& RuleTask,FRuleMatchedInfo& RuleMatchedInfo);
+    // scan all rules together(parallel or asset-major), the result is same as serial scan order
+    void ScanRulesByTask(const TArray<FAssetData>& GlobalAssets,const FScannerClassIndex& GlobalClassIndex,const TArray<TSharedPtr<const FScannerRuleProgram>>& Programs,FMatchedResult& OutResult);
+    // emit every rule as soon as its GameThread lane is finished
+    void MatchGameThreadByRule(TArray<FScannerRuleTask>& RuleTasks,FMatchedResult& OutResult);
+    // operators must be called in GameThread, preload packages if PreloadPackageNum > 0
+    void MatchGameThreadLane(FScannerRuleTask& RuleTask);
+    // record peak memory, release matched preloaded packages and unload packages loaded by scanning if used memory is over MemoryBudgetMB
+    void CheckMemoryBudget(class FScannerPackagePreloader* Preloader);
+    void MatchGameThreadByAsset(TArray<FScannerRuleTask>& RuleTasks);
+    // match by the order of Selectivity and record reject rate if it's valid
+    static bool MatchAllOperators(FScannerAssetContext& Context,const FScannerRuleProgram& Program,const TArray<TSharedPtr<IMatchOperator>>& Operators,FScannerOperatorSelectivity* Selectivity = nullptr);
+    // ignore filters, scan cache and thread safe operators, it can be called out of GameThread
+    static void MatchThreadSafeLane(FScannerRuleTask& RuleTask,int32 AssetIndex,bool bHasOperators,const FScannerScanCache* InScanCache,FScannerOperatorSelectivity* Selectivity = nullptr);
+    void RecordScanCache(const FScannerRuleTask& RuleTask);
+    // send to sinks and add to OutResult, only keep the summary of rule if bStreamResult
+    void EmitRuleResult(FRuleMatchedInfo& RuleMatchedInfo,FMatchedResult& OutResult);
+    // collect matched assets of finished task, emit it and release the candidates
+    void EmitRuleTask(FScannerRuleTask& RuleTask,FMatchedResult& OutResult);
 private:
     TSharedPtr<FScannerConfig> ScannerConfig;
+    // valid in ScanAssets if bUseScanCache
+    TSharedPtr<FScannerScanCache> ScanCache;
+    // valid in ScanAssets
+    FScannerCandidatePlanner CandidatePlanner;
+    // candidates of all rules in ScanAssets, built after rule tasks prepared
+    FScannerAssetSnapshot AssetSnapshot;
+    TArray<TSharedPtr<IScannerResultSink>> ResultSinks;
+    // packages loaded in ScanAssets
+    FScannerPackageTracker PackageTracker;
+    // used physical memory in ScanAssets, not contains memory before scanning
+    uint64 PeakUsedMemory = 0;
+    int32 BudgetGCNum = 0;
+    int32 ShardIndex = 0;
+    int32 ShardNum = 1;
     TMap<FString,TSharedPtr<IMatchOperator>> MatchOperators;
 };
@@ -7,6 +7,9 @@
 
 #include "ReplacePropertyHelper.hpp"
 #include "ResScannerProxy.h"
+#include "FScannerShardScan.h"
+#include "FScannerServer.h"
+#include "FlibResScannerEditorHelper.h"
 
 #include "CoreMinimal.h"
 #include "AssetRegistryModule.h"
@@ -28,32 +31,10 @@ DEFINE_LOG_CATEGORY(LogResScannerCommandlet);
 #define CONTENT_DIR TEXT("-contentdir=")
 #define FILE_CHECK TEXT("-filecheck")
 #define COMMIT_FILE_LIST TEXT("-filelist=")
-
-TArray<FSoftObjectPath> GetCommitFileListObjects(const FString& ContentDir,const FString& FileList)
-{
-	FString NormalContentDir = ContentDir;
-	FPaths::NormalizeFilename(NormalContentDir);
-	
-	TArray<FSoftObjectPath>	result;
-	TArray<FString> FilesArray;
-	FileList.ParseIntoArray(FilesArray,TEXT(","));
-	for(auto& File:FilesArray)
-	{
-		FPaths::NormalizeFilename(File);
-		if(File.StartsWith(NormalContentDir))
-		{
-			File.RemoveAt(0,NormalContentDir.Len());
-			File = FString::Printf(TEXT("/Game/%s"),*File);
-			FSoftObjectPath ObjectPath(File);
-
-			if(ObjectPath.IsValid())
-			{
-				result.Emplace(ObjectPath);
-			}
-		}
-	}
-	return result;
-}
+#define SHARD_QUEUE TEXT("-shardqueue=")
+#define SHARD_NUM TEXT("-shardnum=")
+#define SCAN_SERVER_PORT TEXT("-serverport=")
+#define DEFAULT_SCAN_SERVER_PORT 18089
 
 int32 UResScannerCommandlet::Main(const FString& Params)
 {
@@ -67,6 +48,16 @@ int32 UResScannerCommandlet::Main(const FString& Params)
 		Counter->Processor();
 	}
 	
+	// resident scan server, jobs are submitted by FScannerServerClient
+	if(FParse::Param(FCommandLine::Get(), TEXT("ScanServer")))
+	{
+		int32 ServerPort = DEFAULT_SCAN_SERVER_PORT;
+		FParse::Value(*Params, *FString(SCAN_SERVER_PORT).ToLower(), ServerPort);
+		UFlibAssetParseHelper::GetAssetRegistry(true);
+		FScannerServer Server;
+		return Server.Run(ServerPort) ? 0 : -1;
+	}
+	
 	FString config_path;
 	bool bConfigStatus = FParse::Value(*Params, *FString(COOKER_CONFIG_PARAM_NAME).ToLower(), config_path);
 	if (!bConfigStatus)
@@ -91,7 +82,7 @@ int32 UResScannerCommandlet::Main(const FString& Params)
 	}
 	else
 	{
-		InAssets = GetCommitFileListObjects(FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir()),CommitFileList);
+		InAssets = UFlibResScannerEditorHelper::GetCommitFileListObjects(FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir()),CommitFileList);
 	}
 
 	// PRIVATE_GAllowCommandletRendering = true;
@@ -133,7 +124,15 @@ int32 UResScannerCommandlet::Main(const FString& Params)
 		ScannerProxy->SetScannerConfig(ScannerConfig);
 		ScannerProxy->Init();
 		
-		const FMatchedResult& Result = ScannerProxy->DoScan();;
+		// worker of sharded scanning, launched by coordinator
+		FString ShardQueueFile;
+		int32 ShardNum = 0;
+		if(FParse::Value(*Params,*FString(SHARD_QUEUE).ToLower(),ShardQueueFile) && FParse::Value(*Params,*FString(SHARD_NUM).ToLower(),ShardNum))
+		{
+			return FScannerShardScan::RunWorker(ScannerProxy,ShardQueueFile,ShardNum) ? 0 : -1;
+		}
+		
+		const FMatchedResult& Result = ScannerConfig.WorkerProcessNum > 1 ? FScannerShardScan::RunCoordinator(ScannerProxy) : ScannerProxy->DoScan();
 		FString OutString = Result.SerializeResult(false);
 		
 		UE_LOG(LogResScannerCommandlet, Display, TEXT("\nAsset Scan Result:\n%s"), *OutString);
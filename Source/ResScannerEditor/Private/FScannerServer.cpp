@@ -0,0 +1,262 @@
+#include "FScannerServer.h"
+#include "ResScannerProxy.h"
+#include "FScannerResultSink.h"
+#include "FlibAssetParseHelper.h"
+#include "FlibResScannerEditorHelper.h"
+#include "TemplateHelper.hpp"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+#include "AssetRegistryModule.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogScannerServer, Log, All);
+
+// larger frame is treated as broken stream
+static const uint32 GScannerServerMaxFrame = 256 * 1024 * 1024;
+// client must send the whole job in time, otherwise it blocks other clients and shutdown
+static const FTimespan GScannerServerJobTimeout = FTimespan::FromSeconds(30.0);
+
+static bool SendAll(FSocket* Socket,const uint8* Data,int32 Num)
+{
+	while(Num > 0)
+	{
+		int32 Sent = 0;
+		if(!Socket->Send(Data,Num,Sent) || Sent <= 0)
+		{
+			return false;
+		}
+		Data += Sent;
+		Num -= Sent;
+	}
+	return true;
+}
+
+static bool ReceiveAll(FSocket* Socket,uint8* Data,int32 Num,FTimespan Timeout)
+{
+	while(Num > 0)
+	{
+		if(!Timeout.IsZero() && !Socket->Wait(ESocketWaitConditions::WaitForRead,Timeout))
+		{
+			return false;
+		}
+		int32 Read = 0;
+		if(!Socket->Recv(Data,Num,Read) || Read <= 0)
+		{
+			return false;
+		}
+		Data += Read;
+		Num -= Read;
+	}
+	return true;
+}
+
+static TSharedRef<FInternetAddr> MakeLocalAddr(int32 Port)
+{
+	TSharedRef<FInternetAddr> Addr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+	bool bIsValid = false;
+	Addr->SetIp(TEXT("127.0.0.1"),bIsValid);
+	Addr->SetPort(Port);
+	return Addr;
+}
+
+static void DestroySocket(FSocket*& Socket)
+{
+	if(Socket)
+	{
+		Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		Socket = nullptr;
+	}
+}
+
+bool FScannerServerProtocol::SendFrame(FSocket* Socket,const FString& Content)
+{
+	const FTCHARToUTF8 Converter(*Content);
+	const uint32 Len = Converter.Length();
+	const uint8 Header[4] = {(uint8)(Len & 0xff),(uint8)((Len >> 8) & 0xff),(uint8)((Len >> 16) & 0xff),(uint8)((Len >> 24) & 0xff)};
+	return SendAll(Socket,Header,4) && SendAll(Socket,(const uint8*)Converter.Get(),Len);
+}
+
+bool FScannerServerProtocol::ReceiveFrame(FSocket* Socket,FString& OutContent,FTimespan Timeout)
+{
+	uint8 Header[4];
+	if(!ReceiveAll(Socket,Header,4,Timeout))
+	{
+		return false;
+	}
+	const uint32 Len = Header[0] | (Header[1] << 8) | (Header[2] << 16) | ((uint32)Header[3] << 24);
+	if(Len > GScannerServerMaxFrame)
+	{
+		return false;
+	}
+	TArray<uint8> Buffer;
+	Buffer.SetNumUninitialized(Len);
+	if(!ReceiveAll(Socket,Buffer.GetData(),Len,Timeout))
+	{
+		return false;
+	}
+	const FUTF8ToTCHAR Converter((const ANSICHAR*)Buffer.GetData(),Buffer.Num());
+	OutContent = FString(Converter.Length(),Converter.Get());
+	return true;
+}
+
+bool FScannerServerProtocol::SendMessage(FSocket* Socket,const FString& Type,const FString& Content)
+{
+	FScannerServerMessage Message;
+	Message.Type = Type;
+	Message.Content = Content;
+	FString MessageContent;
+	TemplateHelper::TSerializeStructAsJsonString(Message,MessageContent);
+	return SendFrame(Socket,MessageContent);
+}
+
+// send result of every rule to client as soon as the rule is finished
+class FScannerSocketResultSink : public IScannerResultSink
+{
+public:
+	explicit FScannerSocketResultSink(FSocket* InSocket):Socket(InSocket){}
+	virtual void OnRuleMatched(const FRuleMatchedInfo& RuleMatchedInfo)override
+	{
+		FString RuleContent;
+		TemplateHelper::TSerializeStructAsJsonString(RuleMatchedInfo,RuleContent);
+		FScannerServerProtocol::SendMessage(Socket,TEXT("Rule"),RuleContent);
+	}
+protected:
+	FSocket* Socket;
+};
+
+FScannerServer::~FScannerServer()
+{
+	DestroySocket(ListenSocket);
+	if(ScannerProxy)
+	{
+		ScannerProxy->RemoveFromRoot();
+		ScannerProxy = nullptr;
+	}
+}
+
+bool FScannerServer::Run(int32 Port)
+{
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	ListenSocket = SocketSubsystem->CreateSocket(NAME_Stream,TEXT("ResScannerServer"),false);
+	// only accept local clients
+	if(!ListenSocket || !ListenSocket->Bind(*MakeLocalAddr(Port)) || !ListenSocket->Listen(8))
+	{
+		UE_LOG(LogScannerServer,Error,TEXT("scan server listen on port %d failed."),Port);
+		DestroySocket(ListenSocket);
+		return false;
+	}
+	ScannerProxy = NewObject<UResScannerProxy>();
+	ScannerProxy->AddToRoot();
+	ScannerProxy->Init();
+	PackageTracker.Begin();
+	UE_LOG(LogScannerServer,Display,TEXT("scan server is listening on 127.0.0.1:%d."),Port);
+
+	while(!bShutdown)
+	{
+		bool bHasPendingConnection = false;
+		if(!ListenSocket->WaitForPendingConnection(bHasPendingConnection,FTimespan::FromSeconds(1.0)) || !bHasPendingConnection)
+		{
+			continue;
+		}
+		FSocket* ClientSocket = ListenSocket->Accept(TEXT("ResScannerClient"));
+		if(ClientSocket)
+		{
+			HandleJob(ClientSocket);
+			DestroySocket(ClientSocket);
+		}
+	}
+	UE_LOG(LogScannerServer,Display,TEXT("scan server is shutdown."));
+	return true;
+}
+
+void FScannerServer::HandleJob(FSocket* ClientSocket)
+{
+	SCOPED_NAMED_EVENT_TEXT("FScannerServer::HandleJob",FColor::Red);
+	FString JobContent;
+	FScannerServerJob Job;
+	if(!FScannerServerProtocol::ReceiveFrame(ClientSocket,JobContent,GScannerServerJobTimeout) || !TemplateHelper::TDeserializeJsonStringAsStruct(JobContent,Job))
+	{
+		FScannerServerProtocol::SendMessage(ClientSocket,TEXT("Error"),TEXT("invalid scan job."));
+		return;
+	}
+	if(Job.bShutdown)
+	{
+		bShutdown = true;
+		FScannerServerProtocol::SendMessage(ClientSocket,TEXT("Result"),TEXT(""));
+		return;
+	}
+	
+	FScannerConfig& ScannerConfig = Job.Config;
+	if(Job.FileList.Num())
+	{
+		// files may be changed after the asset registry searched
+		UFlibAssetParseHelper::GetAssetRegistry().ScanFilesSynchronous(Job.FileList,true);
+		ScannerConfig.GlobalScanFilters.Assets.Append(UFlibResScannerEditorHelper::GetCommitFileListObjects(FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir()),FString::Join(Job.FileList,TEXT(","))));
+	}
+	ScannerConfig.bByGlobalScanFilters = ScannerConfig.bByGlobalScanFilters || Job.bFileCheck;
+	UE_LOG(LogScannerServer,Display,TEXT("scan job %s, %d files."),*ScannerConfig.ConfigName,Job.FileList.Num());
+
+	// commiter of last job may set package names transient
+	FRuleMatchedInfo::ResetTransient();
+	TSharedPtr<FScannerSocketResultSink> SocketResultSink = MakeShareable(new FScannerSocketResultSink(ClientSocket));
+	ScannerProxy->SetScannerConfig(ScannerConfig);
+	ScannerProxy->AddResultSink(SocketResultSink);
+	FMatchedResult Result = ScannerProxy->DoScan();
+	ScannerProxy->RemoveResultSink(SocketResultSink);
+	// assets are streamed by Rule messages, only send the summary of rules
+	for(auto& RuleMatchedInfo:Result.GetMatchedInfo())
+	{
+		RuleMatchedInfo.Assets.Empty();
+		RuleMatchedInfo.AssetPackageNames.Empty();
+		RuleMatchedInfo.AssetsCommiter.Empty();
+	}
+	FRuleMatchedInfo::ResetTransient();
+	FScannerServerProtocol::SendMessage(ClientSocket,TEXT("Result"),Result.SerializeResult());
+	// RF_Standalone assets are kept by GC in editor, unload packages loaded by this job
+	const int32 UnloadNum = PackageTracker.UnloadPackages();
+	UE_LOG(LogScannerServer,Display,TEXT("scan job %s finished, unload %d packages."),*ScannerConfig.ConfigName,UnloadNum);
+}
+
+FScannerServerClient::~FScannerServerClient()
+{
+	DestroySocket(Socket);
+}
+
+bool FScannerServerClient::Connect(int32 Port)
+{
+	DestroySocket(Socket);
+	Socket = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateSocket(NAME_Stream,TEXT("ResScannerClient"),false);
+	if(!Socket || !Socket->Connect(*MakeLocalAddr(Port)))
+	{
+		DestroySocket(Socket);
+		return false;
+	}
+	return true;
+}
+
+bool FScannerServerClient::RunJob(const FScannerServerJob& Job,TFunctionRef<void(const FScannerServerMessage&)> OnMessage)
+{
+	FString JobContent;
+	TemplateHelper::TSerializeStructAsJsonString(Job,JobContent);
+	if(!Socket || !FScannerServerProtocol::SendFrame(Socket,JobContent))
+	{
+		return false;
+	}
+	FString MessageContent;
+	while(FScannerServerProtocol::ReceiveFrame(Socket,MessageContent))
+	{
+		FScannerServerMessage Message;
+		if(!TemplateHelper::TDeserializeJsonStringAsStruct(MessageContent,Message))
+		{
+			return false;
+		}
+		OnMessage(Message);
+		if(!Message.Type.Equals(TEXT("Rule")))
+		{
+			return Message.Type.Equals(TEXT("Result"));
+		}
+	}
+	return false;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "FMatchRuleTypes.h"
+#include "FScannerPackagePreloader.h"
+#include "CoreMinimal.h"
+#include "FScannerServer.generated.h"
+
+class FSocket;
+class UResScannerProxy;
+
+// scan job of resident scan server, same as -config and -filelist of commandlet
+USTRUCT()
+struct FScannerServerJob
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	UPROPERTY()
+	FScannerConfig Config;
+	// absolute filenames, they are rescanned by asset registry before scanning
+	UPROPERTY()
+	TArray<FString> FileList;
+	UPROPERTY()
+	bool bFileCheck = false;
+	// stop the server
+	UPROPERTY()
+	bool bShutdown = false;
+};
+
+// Type: Rule(Content is FRuleMatchedInfo json with commiters), Result(Content is FMatchedResult json of rule summaries without assets, last message of job), Error
+USTRUCT()
+struct FScannerServerMessage
+{
+	GENERATED_USTRUCT_BODY()
+public:
+	UPROPERTY()
+	FString Type;
+	UPROPERTY()
+	FString Content;
+};
+
+// messages are utf8 json with 4 bytes little endian length prefix
+struct FScannerServerProtocol
+{
+	static bool SendFrame(FSocket* Socket,const FString& Content);
+	// wait at most Timeout for every read, zero is blocking
+	static bool ReceiveFrame(FSocket* Socket,FString& OutContent,FTimespan Timeout = FTimespan::Zero());
+	static bool SendMessage(FSocket* Socket,const FString& Type,const FString& Content);
+};
+
+// resident commandlet keeps asset registry warm, accepts jobs from localhost one by one
+class FScannerServer
+{
+public:
+	~FScannerServer();
+	// block until shutdown job
+	bool Run(int32 Port);
+
+protected:
+	void HandleJob(FSocket* ClientSocket);
+
+	FSocket* ListenSocket = nullptr;
+	UResScannerProxy* ScannerProxy = nullptr;
+	// packages loaded by jobs are unloaded after every job
+	FScannerPackageTracker PackageTracker;
+	bool bShutdown = false;
+};
+
+class FScannerServerClient
+{
+public:
+	~FScannerServerClient();
+	bool Connect(int32 Port);
+	// OnMessage receives every message until the Result or Error message
+	bool RunJob(const FScannerServerJob& Job,TFunctionRef<void(const FScannerServerMessage&)> OnMessage);
+
+protected:
+	FSocket* Socket = nullptr;
+};
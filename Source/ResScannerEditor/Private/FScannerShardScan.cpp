@@ -0,0 +1,168 @@
+#include "FScannerShardScan.h"
+#include "FlibResScannerEditorHelper.h"
+#include "TemplateHelper.hpp"
+#include "ThreadUtils/FProcWorkerThread.hpp"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogScannerShardScan, Log, All);
+
+FScannerShardQueue::FScannerShardQueue(const FString& InQueueFile):QueueFile(FPaths::ConvertRelativePathToFull(InQueueFile))
+{
+	// name of system wide lock can't contain path separators
+	LockName = FString::Printf(TEXT("ResScannerShardQueue_%s"),*FMD5::HashAnsiString(*QueueFile.ToLower()));
+}
+
+bool FScannerShardQueue::Create(int32 ShardNum)
+{
+	TArray<FString> Lines;
+	for(int32 ShardIndex = 0;ShardIndex < ShardNum;++ShardIndex)
+	{
+		Lines.Add(FString::FromInt(ShardIndex));
+	}
+	return FFileHelper::SaveStringArrayToFile(Lines,*QueueFile);
+}
+
+bool FScannerShardQueue::Pop(int32& OutShardIndex)
+{
+	FSystemWideCriticalSection QueueLock(LockName,FTimespan::FromSeconds(60.0));
+	if(!QueueLock.IsValid())
+	{
+		UE_LOG(LogScannerShardScan,Error,TEXT("lock shard queue %s failed."),*QueueFile);
+		return false;
+	}
+	TArray<FString> Lines;
+	if(!FFileHelper::LoadFileToStringArray(Lines,*QueueFile))
+	{
+		return false;
+	}
+	Lines.RemoveAll([](const FString& Line){ return Line.IsEmpty(); });
+	if(!Lines.Num())
+	{
+		return false;
+	}
+	OutShardIndex = FCString::Atoi(*Lines[0]);
+	Lines.RemoveAt(0);
+	// shard is taken even if saving failed, it may be scanned again by another worker
+	FFileHelper::SaveStringArrayToFile(Lines,*QueueFile);
+	return true;
+}
+
+FString FScannerShardQueue::GetShardResultFile(int32 ShardIndex) const
+{
+	return FPaths::Combine(FPaths::GetPath(QueueFile),FString::Printf(TEXT("shard_%d.json"),ShardIndex));
+}
+
+FMatchedResult FScannerShardScan::ScanShard(UResScannerProxy* ScannerProxy,const TArray<FAssetData>& GlobalAssets,int32 ShardIndex,int32 ShardNum)
+{
+	// packages of shard are stable, scan cache of every shard is kept in a separate file
+	TSharedPtr<FScannerConfig> Config = ScannerProxy->GetScannerConfig();
+	const FString ConfigName = Config->ConfigName;
+	Config->ConfigName = FString::Printf(TEXT("%s_shard%d"),*ConfigName,ShardIndex);
+	ScannerProxy->SetShard(ShardIndex,ShardNum);
+	FMatchedResult ShardResult = ScannerProxy->ScanAssets(GlobalAssets);
+	ScannerProxy->SetShard(0,1);
+	Config->ConfigName = ConfigName;
+	return ShardResult;
+}
+
+FMatchedResult FScannerShardScan::RunCoordinator(UResScannerProxy* ScannerProxy)
+{
+	SCOPED_NAMED_EVENT_TEXT("FScannerShardScan::RunCoordinator",FColor::Red);
+	TSharedPtr<FScannerConfig> Config = ScannerProxy->GetScannerConfig();
+	const int32 WorkerNum = Config->WorkerProcessNum;
+	const int32 ShardNum = WorkerNum * FMath::Max(Config->ShardsPerWorker,1);
+	const FString Name = ScannerProxy->GetResultName();
+	const FString ShardDir = FPaths::ConvertRelativePathToFull(FPaths::Combine(FPaths::ProjectSavedDir(),TEXT("ResScanner"),TEXT("Shards"),FGuid::NewGuid().ToString()));
+
+	// workers only scan shards, config and result are saved by coordinator
+	FScannerConfig WorkerConfig = *Config;
+	WorkerConfig.WorkerProcessNum = 0;
+	WorkerConfig.bSaveConfig = false;
+	WorkerConfig.bSaveResult = false;
+	WorkerConfig.bStreamResult = false;
+	WorkerConfig.GitChecker.bRecordCommiter = false;
+	FString WorkerConfigContent;
+	TemplateHelper::TSerializeStructAsJsonString(WorkerConfig,WorkerConfigContent);
+	const FString WorkerConfigFile = FPaths::Combine(ShardDir,TEXT("config.json"));
+	FFileHelper::SaveStringToFile(WorkerConfigContent,*WorkerConfigFile,FFileHelper::EEncodingOptions::ForceUTF8);
+
+	FScannerShardQueue Queue(FPaths::Combine(ShardDir,TEXT("queue.txt")));
+	Queue.Create(ShardNum);
+	const FString WorkerParams = FString::Printf(TEXT("\"%s\" -run=ResScanner -config=\"%s\" -shardqueue=\"%s\" -shardnum=%d %s %s"),
+		*UFlibResScannerEditorHelper::GetProjectFilePath(),*WorkerConfigFile,*Queue.GetQueueFile(),ShardNum,
+		*Config->AdditionalExecCommand,Config->bNoShaderCompile ? TEXT("-NoShaderCompile -nullrhi") : TEXT(""));
+	UE_LOG(LogScannerShardScan,Display,TEXT("scan %d shards by %d workers: %s %s"),ShardNum,WorkerNum,*UFlibResScannerEditorHelper::GetUECmdBinary(),*WorkerParams);
+
+	TArray<TSharedPtr<FProcWorkerThread>> Workers;
+	for(int32 WorkerIndex = 0;WorkerIndex < WorkerNum;++WorkerIndex)
+	{
+		TSharedPtr<FProcWorkerThread> Worker = MakeShareable(new FProcWorkerThread(*FString::Printf(TEXT("ResScannerShardWorker_%d"),WorkerIndex),UFlibResScannerEditorHelper::GetUECmdBinary(),WorkerParams));
+		Worker->ProcOutputMsgDelegate.AddLambda([WorkerIndex](const FString& Line)
+		{
+			UE_LOG(LogScannerShardScan,Display,TEXT("[Worker%d] %s"),WorkerIndex,*Line);
+		});
+		Worker->Execute();
+		Workers.Add(Worker);
+	}
+	for(const auto& Worker:Workers)
+	{
+		if(Worker->GetThreadStatus() != EThreadStatus::InActive)
+		{
+			Worker->Join();
+		}
+	}
+
+	TArray<FMatchedResult> ShardResults;
+	ShardResults.SetNum(ShardNum);
+	TArray<FAssetData> GlobalAssets;
+	bool bGlobalAssets = false;
+	for(int32 ShardIndex = 0;ShardIndex < ShardNum;++ShardIndex)
+	{
+		FString ShardContent;
+		if(FFileHelper::LoadFileToString(ShardContent,*Queue.GetShardResultFile(ShardIndex)) && TemplateHelper::TDeserializeJsonStringAsStruct(ShardContent,ShardResults[ShardIndex]))
+		{
+			continue;
+		}
+		// worker failed or crashed, scan the shard in coordinator
+		UE_LOG(LogScannerShardScan,Warning,TEXT("shard %d has no result, scan it in coordinator."),ShardIndex);
+		if(!bGlobalAssets)
+		{
+			GlobalAssets = ScannerProxy->GetGlobalAssets();
+			bGlobalAssets = true;
+		}
+		ShardResults[ShardIndex] = ScanShard(ScannerProxy,GlobalAssets,ShardIndex,ShardNum);
+	}
+	FMatchedResult MatchedResult = FMatchedResult::MergeShards(ShardResults);
+	ScannerProxy->SaveScanResult(MatchedResult,Name);
+	IFileManager::Get().DeleteDirectory(*ShardDir,false,true);
+	return MatchedResult;
+}
+
+bool FScannerShardScan::RunWorker(UResScannerProxy* ScannerProxy,const FString& QueueFile,int32 ShardNum)
+{
+	SCOPED_NAMED_EVENT_TEXT("FScannerShardScan::RunWorker",FColor::Red);
+	FScannerShardQueue Queue(QueueFile);
+	TArray<FAssetData> GlobalAssets = ScannerProxy->GetGlobalAssets();
+	bool bStatus = true;
+	int32 ScannedNum = 0;
+	int32 ShardIndex = INDEX_NONE;
+	while(Queue.Pop(ShardIndex))
+	{
+		FMatchedResult ShardResult = ScanShard(ScannerProxy,GlobalAssets,ShardIndex,ShardNum);
+		FString ShardContent;
+		TemplateHelper::TSerializeStructAsJsonString(ShardResult,ShardContent);
+		// coordinator never reads a partial result
+		const FString ResultFile = Queue.GetShardResultFile(ShardIndex);
+		const FString TempFile = ResultFile + TEXT(".tmp");
+		const bool bSaved = FFileHelper::SaveStringToFile(ShardContent,*TempFile,FFileHelper::EEncodingOptions::ForceUTF8) && IFileManager::Get().Move(*ResultFile,*TempFile);
+		UE_LOG(LogScannerShardScan,Display,TEXT("save result of shard %d %s."),ShardIndex,bSaved ? TEXT("successd") : TEXT("failed"));
+		bStatus = bStatus && bSaved;
+		++ScannedNum;
+	}
+	UE_LOG(LogScannerShardScan,Display,TEXT("worker scanned %d shards."),ScannedNum);
+	return bStatus;
+}
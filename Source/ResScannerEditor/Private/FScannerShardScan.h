@@ -0,0 +1,33 @@
+#pragma once
+#include "ResScannerProxy.h"
+#include "CoreMinimal.h"
+
+// shard indices in a local file, shared by all worker processes and guarded by a system wide lock
+class FScannerShardQueue
+{
+public:
+	explicit FScannerShardQueue(const FString& InQueueFile);
+	bool Create(int32 ShardNum);
+	// false if all shards are taken
+	bool Pop(int32& OutShardIndex);
+	const FString& GetQueueFile()const { return QueueFile; }
+	// result of shard is saved in the directory of queue file
+	FString GetShardResultFile(int32 ShardIndex)const;
+
+protected:
+	FString QueueFile;
+	FString LockName;
+};
+
+// coordinator splits candidate packages into shards by package name and launches worker commandlets,
+// every worker takes remaining shards from the queue until it's empty, then results of all shards are merged
+struct FScannerShardScan
+{
+	// scan and save the merged result like UResScannerProxy::DoScan
+	static FMatchedResult RunCoordinator(UResScannerProxy* ScannerProxy);
+	// false if any shard result failed to save
+	static bool RunWorker(UResScannerProxy* ScannerProxy,const FString& QueueFile,int32 ShardNum);
+
+protected:
+	static FMatchedResult ScanShard(UResScannerProxy* ScannerProxy,const TArray<FAssetData>& GlobalAssets,int32 ShardIndex,int32 ShardNum);
+};
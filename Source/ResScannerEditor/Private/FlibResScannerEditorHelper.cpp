@@ -107,5 +107,31 @@ FString UFlibResScannerEditorHelper::GetProjectFilePath()
 	return ProjectFilePath;
 }
 
+TArray<FSoftObjectPath> UFlibResScannerEditorHelper::GetCommitFileListObjects(const FString& ContentDir,const FString& FileList)
+{
+	FString NormalContentDir = ContentDir;
+	FPaths::NormalizeFilename(NormalContentDir);
+	
+	TArray<FSoftObjectPath>	result;
+	TArray<FString> FilesArray;
+	FileList.ParseIntoArray(FilesArray,TEXT(","));
+	for(auto& File:FilesArray)
+	{
+		FPaths::NormalizeFilename(File);
+		if(File.StartsWith(NormalContentDir))
+		{
+			File.RemoveAt(0,NormalContentDir.Len());
+			File = FString::Printf(TEXT("/Game/%s"),*File);
+			FSoftObjectPath ObjectPath(File);
+
+			if(ObjectPath.IsValid())
+			{
+				result.Emplace(ObjectPath);
+			}
+		}
+	}
+	return result;
+}
+
 
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "ResScannerEditor.h"
 #include "DetailCustomization/ScannerSettingsDetails.h"
 #include "FlibResScannerEditorHelper.h"
+#include "FScannerServer.h"
 
 // engine header
 #include "Misc/FileHelper.h"
@@ -17,6 +18,7 @@
 #include "Misc/SecureHash.h"
 #include "HAL/FileManager.h"
 #include "Kismet/KismetTextLibrary.h"
+#include "Async/Async.h"
 
 #define LOCTEXT_NAMESPACE "SResScannerConfigPage"
 
@@ -197,6 +199,56 @@ void SResScannerConfigPage::DoScanWork()const
 		ContentsWidget->SetContent(TEXT(""));
 		ContentsWidget->SetExpanded(false);
 		ContentsWidget->SetVisibility(EVisibility::Hidden);
+
+		// submit to resident scan server if it is running, skip the engine startup of commandlet
+		TSharedPtr<FScannerServerClient,ESPMode::ThreadSafe> ServerClient = MakeShared<FScannerServerClient,ESPMode::ThreadSafe>();
+		if(ScannerConfig->ScanServerPort > 0 && ServerClient->Connect(ScannerConfig->ScanServerPort))
+		{
+			FScannerServerJob Job;
+			Job.Config = *ScannerConfig;
+			TWeakPtr<SResScannerContents> WeakContents = ContentsWidget;
+			Async(EAsyncExecution::Thread,[ServerClient,Job,WeakContents]()mutable
+			{
+				TArray<FString> RuleContents;
+				FString ErrorContent;
+				bool bSuccessed = ServerClient->RunJob(Job,[&RuleContents,&ErrorContent](const FScannerServerMessage& Message)
+				{
+					if(Message.Type.Equals(TEXT("Rule")))
+					{
+						RuleContents.Add(Message.Content);
+					}
+					else if(Message.Type.Equals(TEXT("Error")))
+					{
+						ErrorContent = Message.Content;
+					}
+				});
+				UE_LOG(LogTemp,Log,TEXT("ResScanner %s scan server job %s. %s"),*Job.Config.ConfigName,bSuccessed ? TEXT("successed") : TEXT("faild"),*ErrorContent);
+				// property flags of FRuleMatchedInfo are changed by serializing, deserialize in GameThread
+				AsyncTask(ENamedThreads::GameThread,[WeakContents = MoveTemp(WeakContents),RuleContents = MoveTemp(RuleContents),Config = MoveTemp(Job.Config)]()
+				{
+					FRuleMatchedInfo::ResetTransient();
+					FMatchedResult Result;
+					for(const auto& RuleContent:RuleContents)
+					{
+						FRuleMatchedInfo RuleMatchedInfo;
+						if(TemplateHelper::TDeserializeJsonStringAsStruct(RuleContent,RuleMatchedInfo))
+						{
+							Result.GetMatchedInfo().Add(MoveTemp(RuleMatchedInfo));
+						}
+					}
+					// commiters are recorded by server, only set the serialize flags
+					Result.RecordGitCommiter(Config.GitChecker.bGitCheck && Config.GitChecker.bRecordCommiter,Config.GitChecker.GetRepoDir());
+					FString OutString = Result.SerializeResult(Config.bSavaeLiteResult);
+					if(TSharedPtr<SResScannerContents> Contents = WeakContents.Pin())
+					{
+						Contents->SetContent(OutString);
+						Contents->SetExpanded(true);
+						Contents->SetVisibility(EVisibility::Visible);
+					}
+				});
+			});
+			return;
+		}
 		
 		FString CurrentConfig;
 		TemplateHelper::TSerializeStructAsJsonString(*ScannerConfig,CurrentConfig);
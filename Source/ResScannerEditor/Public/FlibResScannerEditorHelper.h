@@ -19,5 +19,7 @@ public:
 	static TArray<FString> SaveFileDialog();
 	static FString GetUECmdBinary();
 	static FString GetProjectFilePath();
+	// FileList is absolute filenames split by ",", files not in ContentDir are ignored
+	static TArray<FSoftObjectPath> GetCommitFileListObjects(const FString& ContentDir,const FString& FileList);
 	
 };